@@ -106,6 +106,14 @@ void MainWindow::onLoadingChanged(const QWebViewLoadRequestPrivate &loadRequest)
                                              .arg(loadRequest.m_url.toString())
                                              .arg(loadRequest.m_errorString));
         break;
+    case QWebView::LoadRedirectedStatus:
+        ui->logEdit->appendPlainText(QString("redirect, %1").arg(loadRequest.m_url.toString()));
+        break;
+    case QWebView::LoadCommittedStatus:
+        ui->logEdit->appendPlainText(QString("commit, %1, HTTP %2")
+                                             .arg(loadRequest.m_url.toString())
+                                             .arg(loadRequest.m_httpStatusCode));
+        break;
     case QWebView::LoadSucceededStatus:
         ui->actionRefresh->setIcon(style()->standardIcon(QStyle::SP_BrowserReload));
         ui->logEdit->appendPlainText(QString("success, %1, %2")
@@ -0,0 +1,409 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxcookiestore_p.h"
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qset.h>
+
+#include <climits>
+
+QT_BEGIN_NAMESPACE
+
+using SoupCookiesCallback = std::function<void(void *cookies)>;
+
+namespace {
+struct CookieBatch
+{
+    QLinuxCookieStore::Callback callback;
+    QList<QLinuxCookie> cookies;
+    int pending = 1; // released once all requests have been issued
+
+    void finish()
+    {
+        if (--pending > 0)
+            return;
+        if (callback)
+            callback(cookies);
+        delete this;
+    }
+};
+
+struct CookieRequest
+{
+    CookieBatch *batch;
+    QLinuxCookie cookie;
+};
+
+#if !WEBKIT_CHECK_VERSION(2, 42, 0)
+struct CookieFetch
+{
+    SoupCookiesCallback callback;
+    WebKitCookieManager *manager = nullptr;
+    GList *cookies = nullptr;
+    QSet<QString> seen;
+    int pending = 1;
+};
+#endif
+} // namespace
+
+static QString normalizedDomain(const QString &domain)
+{
+    return domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain;
+}
+
+static SoupCookie *toSoupCookie(const QLinuxCookie &cookie)
+{
+    int maxAge = -1;
+    if (cookie.expirationDate.isValid()) {
+        const qint64 secs = QDateTime::currentDateTimeUtc().secsTo(cookie.expirationDate);
+        maxAge = int(qBound<qint64>(0, secs, INT_MAX));
+    }
+
+    const QString path = cookie.path.isEmpty() ? QStringLiteral("/") : cookie.path;
+    SoupCookie *soupCookie = soup_cookie_new(
+            cookie.name.toUtf8().constData(), cookie.value.toUtf8().constData(),
+            cookie.domain.toUtf8().constData(), path.toUtf8().constData(), maxAge);
+    soup_cookie_set_secure(soupCookie, cookie.secure);
+    soup_cookie_set_http_only(soupCookie, cookie.httpOnly);
+    return soupCookie;
+}
+
+static QLinuxCookie fromSoupCookie(SoupCookie *soupCookie)
+{
+    QLinuxCookie cookie;
+    cookie.domain = QString::fromUtf8(soup_cookie_get_domain(soupCookie));
+    cookie.name = QString::fromUtf8(soup_cookie_get_name(soupCookie));
+    cookie.value = QString::fromUtf8(soup_cookie_get_value(soupCookie));
+    cookie.path = QString::fromUtf8(soup_cookie_get_path(soupCookie));
+    cookie.secure = soup_cookie_get_secure(soupCookie);
+    cookie.httpOnly = soup_cookie_get_http_only(soupCookie);
+#if SOUP_CHECK_VERSION(3, 0, 0)
+    if (GDateTime *expires = soup_cookie_get_expires(soupCookie))
+        cookie.expirationDate = QDateTime::fromSecsSinceEpoch(g_date_time_to_unix(expires), Qt::UTC);
+#else
+    if (SoupDate *expires = soup_cookie_get_expires(soupCookie))
+        cookie.expirationDate = QDateTime::fromSecsSinceEpoch(soup_date_to_time_t(expires), Qt::UTC);
+#endif
+    return cookie;
+}
+
+static void freeSoupCookies(GList *cookies)
+{
+    g_list_free_full(cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
+}
+
+static void cookieAddFinished(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    CookieRequest *request = static_cast<CookieRequest *>(userData);
+    GError *error = nullptr;
+    if (webkit_cookie_manager_add_cookie_finish(WEBKIT_COOKIE_MANAGER(object), result, &error)) {
+        request->batch->cookies.append(request->cookie);
+    } else {
+        qWarning() << "Failed to add cookie" << request->cookie.name << error->message;
+        g_error_free(error);
+    }
+    request->batch->finish();
+    delete request;
+}
+
+static void cookieDeleteFinished(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    CookieRequest *request = static_cast<CookieRequest *>(userData);
+    GError *error = nullptr;
+    if (webkit_cookie_manager_delete_cookie_finish(WEBKIT_COOKIE_MANAGER(object), result, &error)) {
+        request->batch->cookies.append(request->cookie);
+    } else {
+        qWarning() << "Failed to delete cookie" << request->cookie.name << error->message;
+        g_error_free(error);
+    }
+    request->batch->finish();
+    delete request;
+}
+
+#if !WEBKIT_CHECK_VERSION(2, 42, 0)
+static void finishFetch(CookieFetch *fetch)
+{
+    if (--fetch->pending > 0)
+        return;
+    fetch->callback(fetch->cookies);
+    freeSoupCookies(fetch->cookies);
+    g_object_unref(fetch->manager);
+    delete fetch;
+}
+
+static void domainCookiesReceived(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    CookieFetch *fetch = static_cast<CookieFetch *>(userData);
+    GError *error = nullptr;
+    GList *cookies =
+            webkit_cookie_manager_get_cookies_finish(WEBKIT_COOKIE_MANAGER(object), result, &error);
+    if (error) {
+        qWarning() << "Failed to fetch cookies:" << error->message;
+        g_error_free(error);
+    }
+
+    // Cookies set on a parent domain show up for each of its subdomains
+    for (GList *it = cookies; it; it = it->next) {
+        SoupCookie *soupCookie = static_cast<SoupCookie *>(it->data);
+        const QString key = QString::fromUtf8(soup_cookie_get_domain(soupCookie))
+                + QLatin1Char('\t') + QString::fromUtf8(soup_cookie_get_path(soupCookie))
+                + QLatin1Char('\t') + QString::fromUtf8(soup_cookie_get_name(soupCookie));
+        if (fetch->seen.contains(key)) {
+            soup_cookie_free(soupCookie);
+        } else {
+            fetch->seen.insert(key);
+            fetch->cookies = g_list_prepend(fetch->cookies, soupCookie);
+        }
+    }
+    g_list_free(cookies);
+    finishFetch(fetch);
+}
+
+static void cookieDomainsReceived(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    CookieFetch *fetch = static_cast<CookieFetch *>(userData);
+    GError *error = nullptr;
+    GList *websites = webkit_website_data_manager_fetch_finish(WEBKIT_WEBSITE_DATA_MANAGER(object),
+                                                              result, &error);
+    if (error) {
+        qWarning() << "Failed to fetch cookie domains:" << error->message;
+        g_error_free(error);
+    }
+
+    for (GList *it = websites; it; it = it->next) {
+        const char *name = webkit_website_data_get_name(static_cast<WebKitWebsiteData *>(it->data));
+        const QByteArray uri = "https://" + QByteArray(name) + '/';
+        ++fetch->pending;
+        webkit_cookie_manager_get_cookies(fetch->manager, uri.constData(), nullptr,
+                                          domainCookiesReceived, fetch);
+    }
+    g_list_free_full(websites, reinterpret_cast<GDestroyNotify>(webkit_website_data_unref));
+    finishFetch(fetch);
+}
+#endif
+
+QLinuxCookieStore::QLinuxCookieStore(void *cookieManager, void *dataManager, QObject *parent)
+    : QObject(parent), m_cookieManager(g_object_ref(cookieManager)),
+      m_dataManager(g_object_ref(dataManager))
+{
+}
+
+QLinuxCookieStore::~QLinuxCookieStore()
+{
+    g_object_unref(m_cookieManager);
+    g_object_unref(m_dataManager);
+}
+
+void QLinuxCookieStore::setPersistentStorage(const QString &fileName, StorageFormat format)
+{
+    webkit_cookie_manager_set_persistent_storage(
+            static_cast<WebKitCookieManager *>(m_cookieManager),
+            QFile::encodeName(fileName).constData(),
+            format == TextStorage ? WEBKIT_COOKIE_PERSISTENT_STORAGE_TEXT
+                                  : WEBKIT_COOKIE_PERSISTENT_STORAGE_SQLITE);
+}
+
+void QLinuxCookieStore::addCookies(const QList<QLinuxCookie> &cookies, const Callback &callback)
+{
+    WebKitCookieManager *manager = static_cast<WebKitCookieManager *>(m_cookieManager);
+    CookieBatch *batch = new CookieBatch;
+    batch->callback = callback;
+
+    for (const QLinuxCookie &cookie : cookies) {
+        // WebKit converts the cookie right away, it can be freed after the call
+        SoupCookie *soupCookie = toSoupCookie(cookie);
+        ++batch->pending;
+        webkit_cookie_manager_add_cookie(manager, soupCookie, nullptr, cookieAddFinished,
+                                         new CookieRequest{ batch, cookie });
+        soup_cookie_free(soupCookie);
+    }
+    batch->finish();
+}
+
+void QLinuxCookieStore::deleteCookies(const QList<QLinuxCookie> &cookies, const Callback &callback)
+{
+    QSet<QString> keys;
+    for (const QLinuxCookie &cookie : cookies)
+        keys.insert(normalizedDomain(cookie.domain) + QLatin1Char('\t') + cookie.name);
+
+    QPointer<QLinuxCookieStore> self(this);
+    fetchSoupCookies([self, keys, callback](void *soupCookies) {
+        if (!self)
+            return;
+        self->deleteSoupCookies(
+                soupCookies,
+                [&keys](const QLinuxCookie &cookie) {
+                    return keys.contains(normalizedDomain(cookie.domain) + QLatin1Char('\t')
+                                         + cookie.name);
+                },
+                callback);
+    });
+}
+
+void QLinuxCookieStore::deleteAllCookies(const Callback &callback)
+{
+    QPointer<QLinuxCookieStore> self(this);
+    fetchSoupCookies([self, callback](void *soupCookies) {
+        if (self)
+            self->deleteSoupCookies(soupCookies, [](const QLinuxCookie &) { return true; },
+                                    callback);
+    });
+}
+
+void QLinuxCookieStore::allCookies(const Callback &callback)
+{
+    fetchSoupCookies([callback](void *soupCookies) {
+        QList<QLinuxCookie> cookies;
+        for (GList *it = static_cast<GList *>(soupCookies); it; it = it->next)
+            cookies.append(fromSoupCookie(static_cast<SoupCookie *>(it->data)));
+        callback(cookies);
+    });
+}
+
+void QLinuxCookieStore::importCookieJar(const QString &fileName, const Callback &callback)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot read cookie jar" << fileName << file.errorString();
+        if (callback)
+            callback(QList<QLinuxCookie>());
+        return;
+    }
+    addCookies(parseCookieJar(file.readAll()), callback);
+}
+
+void QLinuxCookieStore::exportCookieJar(const QString &fileName,
+                                        const std::function<void(bool)> &callback)
+{
+    allCookies([fileName, callback](const QList<QLinuxCookie> &cookies) {
+        const QByteArray data = serializeCookieJar(cookies);
+        QSaveFile file(fileName);
+        const bool ok = file.open(QIODevice::WriteOnly) && file.write(data) == data.size()
+                && file.commit();
+        if (!ok)
+            qWarning() << "Cannot write cookie jar" << fileName << file.errorString();
+        if (callback)
+            callback(ok);
+    });
+}
+
+QList<QLinuxCookie> QLinuxCookieStore::parseCookieJar(const QByteArray &data)
+{
+    static const char httpOnlyPrefix[] = "#HttpOnly_";
+
+    QList<QLinuxCookie> cookies;
+    const QList<QByteArray> lines = data.split('\n');
+    for (QByteArray line : lines) {
+        if (line.endsWith('\r'))
+            line.chop(1);
+
+        bool httpOnly = false;
+        if (line.startsWith(httpOnlyPrefix)) {
+            httpOnly = true;
+            line.remove(0, int(sizeof(httpOnlyPrefix)) - 1);
+        } else if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        // domain, include subdomains, path, secure, expiry, name, value
+        const QList<QByteArray> fields = line.split('\t');
+        if (fields.size() < 7)
+            continue;
+
+        QLinuxCookie cookie;
+        cookie.domain = QString::fromUtf8(fields.at(0));
+        cookie.path = QString::fromUtf8(fields.at(2));
+        cookie.secure = fields.at(3) == "TRUE";
+        const qint64 expires = fields.at(4).toLongLong();
+        if (expires > 0)
+            cookie.expirationDate = QDateTime::fromSecsSinceEpoch(expires, Qt::UTC);
+        cookie.name = QString::fromUtf8(fields.at(5));
+        cookie.value = QString::fromUtf8(fields.at(6));
+        cookie.httpOnly = httpOnly;
+        cookies.append(cookie);
+    }
+    return cookies;
+}
+
+QByteArray QLinuxCookieStore::serializeCookieJar(const QList<QLinuxCookie> &cookies)
+{
+    QByteArray data = "# Netscape HTTP Cookie File\n";
+    for (const QLinuxCookie &cookie : cookies) {
+        if (cookie.httpOnly)
+            data += "#HttpOnly_";
+        data += cookie.domain.toUtf8();
+        data += cookie.domain.startsWith(QLatin1Char('.')) ? "\tTRUE\t" : "\tFALSE\t";
+        data += cookie.path.toUtf8();
+        data += cookie.secure ? "\tTRUE\t" : "\tFALSE\t";
+        data += QByteArray::number(
+                cookie.expirationDate.isValid() ? cookie.expirationDate.toSecsSinceEpoch() : 0);
+        data += '\t';
+        data += cookie.name.toUtf8();
+        data += '\t';
+        data += cookie.value.toUtf8();
+        data += '\n';
+    }
+    return data;
+}
+
+void QLinuxCookieStore::fetchSoupCookies(const std::function<void(void *)> &callback)
+{
+    WebKitCookieManager *manager = static_cast<WebKitCookieManager *>(m_cookieManager);
+#if WEBKIT_CHECK_VERSION(2, 42, 0)
+    webkit_cookie_manager_get_all_cookies(
+            manager, nullptr,
+            +[](GObject *object, GAsyncResult *result, gpointer userData) {
+                SoupCookiesCallback *callback = static_cast<SoupCookiesCallback *>(userData);
+                GError *error = nullptr;
+                GList *cookies = webkit_cookie_manager_get_all_cookies_finish(
+                        WEBKIT_COOKIE_MANAGER(object), result, &error);
+                if (error) {
+                    qWarning() << "Failed to fetch cookies:" << error->message;
+                    g_error_free(error);
+                }
+                (*callback)(cookies);
+                freeSoupCookies(cookies);
+                delete callback;
+            },
+            new SoupCookiesCallback(callback));
+#else
+    // There is no way to list every cookie before 2.42, query the domains that
+    // have cookies instead. Only cookies visible to "/" are found this way.
+    CookieFetch *fetch = new CookieFetch;
+    fetch->callback = callback;
+    fetch->manager = WEBKIT_COOKIE_MANAGER(g_object_ref(manager));
+    webkit_website_data_manager_fetch(static_cast<WebKitWebsiteDataManager *>(m_dataManager),
+                                      WEBKIT_WEBSITE_DATA_COOKIES, nullptr, cookieDomainsReceived,
+                                      fetch);
+#endif
+}
+
+void QLinuxCookieStore::deleteSoupCookies(void *cookies,
+                                          const std::function<bool(const QLinuxCookie &)> &match,
+                                          const Callback &callback)
+{
+    WebKitCookieManager *manager = static_cast<WebKitCookieManager *>(m_cookieManager);
+    CookieBatch *batch = new CookieBatch;
+    batch->callback = callback;
+
+    for (GList *it = static_cast<GList *>(cookies); it; it = it->next) {
+        SoupCookie *soupCookie = static_cast<SoupCookie *>(it->data);
+        const QLinuxCookie cookie = fromSoupCookie(soupCookie);
+        if (!match(cookie))
+            continue;
+        ++batch->pending;
+        webkit_cookie_manager_delete_cookie(manager, soupCookie, nullptr, cookieDeleteFinished,
+                                            new CookieRequest{ batch, cookie });
+    }
+    batch->finish();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,82 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXCOOKIESTORE_P_H
+#define QLINUXCOOKIESTORE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qstring.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+struct QLinuxCookie
+{
+    QString domain;
+    QString name;
+    QString value;
+    QString path = QStringLiteral("/");
+    QDateTime expirationDate; // invalid for session cookies
+    bool secure = false;
+    bool httpOnly = false;
+};
+
+// Cookies of one web context. Batches issue every request to the network
+// process at once and report back a single time when all of them are done.
+class QLinuxCookieStore : public QObject
+{
+    Q_OBJECT
+public:
+    // Receives the cookies the operation was applied to
+    using Callback = std::function<void(const QList<QLinuxCookie> &cookies)>;
+
+    enum StorageFormat {
+        SqliteStorage,
+        TextStorage // Netscape cookies.txt
+    };
+
+    QLinuxCookieStore(void *cookieManager, void *dataManager, QObject *parent = nullptr);
+    ~QLinuxCookieStore() override;
+
+    void setPersistentStorage(const QString &fileName, StorageFormat format = SqliteStorage);
+
+    void addCookies(const QList<QLinuxCookie> &cookies, const Callback &callback = Callback());
+    // Matched by domain and name
+    void deleteCookies(const QList<QLinuxCookie> &cookies, const Callback &callback = Callback());
+    void deleteAllCookies(const Callback &callback = Callback());
+    void allCookies(const Callback &callback);
+
+    void importCookieJar(const QString &fileName, const Callback &callback = Callback());
+    void exportCookieJar(const QString &fileName,
+                         const std::function<void(bool ok)> &callback = nullptr);
+
+    static QList<QLinuxCookie> parseCookieJar(const QByteArray &data);
+    static QByteArray serializeCookieJar(const QList<QLinuxCookie> &cookies);
+
+private:
+    void fetchSoupCookies(const std::function<void(void *cookies)> &callback);
+    void deleteSoupCookies(void *cookies, const std::function<bool(const QLinuxCookie &)> &match,
+                           const Callback &callback);
+
+    void *m_cookieManager; // WebKitCookieManager
+    void *m_dataManager; // WebKitWebsiteDataManager
+};
+
+QT_END_NAMESPACE
+
+#endif // QLINUXCOOKIESTORE_P_H
@@ -0,0 +1,253 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <glib.h>
+#include <gtk/gtk.h>
+// clang-format on
+
+#include "qlinuxgtkthread_p.h"
+#include <qwebviewtrace_p.h>
+
+#include <QtCore/qabstracteventdispatcher.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct CommandNode
+{
+    std::atomic<CommandNode *> next{ nullptr };
+    QLinuxGtkThread::Command command;
+};
+
+// Intrusive multiple producer, single consumer queue after Dmitry Vyukov.
+// Pushing is one atomic exchange; only the GTK thread pops.
+class CommandQueue
+{
+public:
+    CommandQueue() : m_head(&m_stub), m_tail(&m_stub) { }
+
+    ~CommandQueue()
+    {
+        while (CommandNode *node = pop())
+            delete node;
+    }
+
+    void push(CommandNode *node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        CommandNode *previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_release);
+    }
+
+    // Returns nullptr when empty, or while a push is halfway through
+    CommandNode *pop()
+    {
+        CommandNode *tail = m_tail;
+        CommandNode *next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub) {
+            if (!next)
+                return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (!next) {
+            if (tail != m_head.load(std::memory_order_acquire))
+                return nullptr;
+            push(&m_stub);
+            m_size.fetch_sub(1, std::memory_order_relaxed); // the stub does not count
+            next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return nullptr;
+        }
+        m_tail = next;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return tail;
+    }
+
+    bool isEmpty() const { return m_size.load(std::memory_order_acquire) == 0; }
+
+private:
+    std::atomic<CommandNode *> m_head;
+    CommandNode *m_tail;
+    CommandNode m_stub;
+    std::atomic<int> m_size{ 0 };
+};
+
+struct CommandSource
+{
+    GSource source;
+    CommandQueue *queue;
+};
+
+// Bounds the time spent in one dispatch, so that GTK's own sources get their turn
+static const int maximumCommandsPerDispatch = 64;
+
+GSourceFuncs commandSourceFuncs = {
+    // prepare
+    [](GSource *source, gint *timeout) -> gboolean {
+        *timeout = -1;
+        return !reinterpret_cast<CommandSource *>(source)->queue->isEmpty();
+    },
+    // check
+    [](GSource *source) -> gboolean {
+        return !reinterpret_cast<CommandSource *>(source)->queue->isEmpty();
+    },
+    // dispatch
+    [](GSource *source, GSourceFunc, gpointer) -> gboolean {
+        CommandQueue *queue = reinterpret_cast<CommandSource *>(source)->queue;
+        for (int i = 0; i < maximumCommandsPerDispatch; ++i) {
+            CommandNode *node = queue->pop();
+            if (!node)
+                break;
+            Q_WEBVIEW_TRACE_SPAN("QLinuxGtkThread::command");
+            node->command();
+            delete node;
+        }
+        return G_SOURCE_CONTINUE;
+    },
+    // finalize
+    nullptr,
+};
+
+class GtkThread : public QThread
+{
+public:
+    GtkThread()
+    {
+        setObjectName(QStringLiteral("QtWebViewGtk"));
+        start();
+        m_ready.acquire();
+    }
+
+    ~GtkThread() override
+    {
+        post([this]() { g_main_loop_quit(m_loop); });
+        wait();
+    }
+
+    void post(QLinuxGtkThread::Command command)
+    {
+        CommandNode *node = new CommandNode;
+        node->command = std::move(command);
+        m_queue.push(node);
+        g_main_context_wakeup(g_main_context_default());
+    }
+
+protected:
+    void run() override
+    {
+        // GTK and GDK attach their sources to the default context, so this
+        // thread has to be the one running it.
+        GMainContext *context = g_main_context_default();
+        gtk_init(nullptr, nullptr);
+
+        GSource *source = g_source_new(&commandSourceFuncs, sizeof(CommandSource));
+        reinterpret_cast<CommandSource *>(source)->queue = &m_queue;
+        g_source_attach(source, context);
+        m_loop = g_main_loop_new(context, FALSE);
+        m_ready.release();
+
+        g_main_loop_run(m_loop);
+
+        g_source_destroy(source);
+        g_source_unref(source);
+        g_main_loop_unref(m_loop);
+    }
+
+private:
+    CommandQueue m_queue;
+    GMainLoop *m_loop = nullptr;
+    QSemaphore m_ready;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(GtkThread, gtkThread)
+
+bool QLinuxGtkThread::isEnabled()
+{
+    // -1 until decided, which needs the event dispatcher of the application
+    static std::atomic<int> enabled{ -1 };
+    const int cached = enabled.load(std::memory_order_acquire);
+    if (cached >= 0)
+        return cached;
+
+    if (!qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_GTK_THREAD"))
+        return false;
+    QCoreApplication *application = QCoreApplication::instance();
+    if (!application)
+        return false;
+
+    // Qt's GLib dispatcher would run the default context as well
+    QAbstractEventDispatcher *dispatcher =
+            QAbstractEventDispatcher::instance(application->thread());
+    const int value = dispatcher && !dispatcher->inherits("QEventDispatcherGlib") ? 1 : 0;
+    int expected = -1;
+    if (enabled.compare_exchange_strong(expected, value, std::memory_order_acq_rel)
+        && !value) {
+        qWarning("QT_WEBVIEW_LINUX_GTK_THREAD requires QT_NO_GLIB=1, "
+                 "running GTK on the GUI thread");
+    }
+    return value;
+}
+
+bool QLinuxGtkThread::isCurrentThread()
+{
+    // Cleanup after the thread has been shut down runs wherever it is called
+    return !isEnabled() || gtkThread.isDestroyed() || QThread::currentThread() == gtkThread();
+}
+
+void QLinuxGtkThread::initializeGtk()
+{
+    Q_ASSERT(isCurrentThread());
+    // The dedicated thread has initialized it before taking any command
+    static bool initialized = isEnabled();
+    if (!initialized) {
+        gtk_init(nullptr, nullptr);
+        initialized = true;
+    }
+}
+
+void QLinuxGtkThread::post(Command command)
+{
+    if (isCurrentThread())
+        command();
+    else
+        gtkThread->post(std::move(command));
+}
+
+void QLinuxGtkThread::invoke(const Command &command)
+{
+    if (isCurrentThread()) {
+        command();
+        return;
+    }
+
+    // Time the calling thread is blocked
+    Q_WEBVIEW_TRACE_SPAN("QLinuxGtkThread::invoke");
+    QSemaphore done;
+    gtkThread->post([&command, &done]() {
+        command();
+        done.release();
+    });
+    done.acquire();
+}
+
+void QLinuxGtkThread::deliver(QObject *receiver, Command function)
+{
+    if (QThread::currentThread() == receiver->thread())
+        function();
+    else
+        QMetaObject::invokeMethod(receiver, std::move(function), Qt::QueuedConnection);
+}
+
+QT_END_NAMESPACE
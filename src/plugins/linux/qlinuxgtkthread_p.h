@@ -0,0 +1,62 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXGTKTHREAD_P_H
+#define QLINUXGTKTHREAD_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+
+// The thread all GTK and WebKit calls are made on.
+//
+// By default that is the GUI thread, and Qt's GLib event dispatcher runs the
+// default main context. With QT_WEBVIEW_LINUX_GTK_THREAD=1 a dedicated thread
+// owns the default main context instead, and commands reach it through a
+// lock-free queue. Qt must then not iterate that context itself, so the option
+// requires QT_NO_GLIB=1; it is ignored with a warning otherwise.
+//
+// On the GTK thread there is no Qt event loop. QObjects may be created there,
+// but get no events, timers or queued calls while they live on it; only direct
+// connections work. Move them to a thread with an event loop for anything
+// else, and send results back through deliver().
+class QLinuxGtkThread
+{
+public:
+    using Command = std::function<void()>;
+
+    static bool isEnabled();
+    // True wherever GTK may be called directly
+    static bool isCurrentThread();
+    // Calls gtk_init() the first time, must run on the GTK thread
+    static void initializeGtk();
+
+    // Runs the command on the GTK thread, commands run in the order they
+    // were posted. Inline when already on the GTK thread.
+    static void post(Command command);
+    // Same, but waits for the command to finish
+    static void invoke(const Command &command);
+
+    // Runs the function on the thread of the receiver, inline when already
+    // there. Dropped if the receiver is destroyed in the meantime.
+    static void deliver(QObject *receiver, Command function);
+};
+
+QT_END_NAMESPACE
+
+#endif // QLINUXGTKTHREAD_P_H
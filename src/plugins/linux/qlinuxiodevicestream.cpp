@@ -0,0 +1,222 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qlinuxiodevicestream_p.h"
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/qthread.h>
+
+QT_USE_NAMESPACE
+
+struct QIODeviceInputStream
+{
+    GInputStream parent;
+    QIODevice *device;
+    QObject *notifier; // context of the device connections
+    bool finished;
+
+    // Read waiting for data from a sequential device
+    GTask *pendingTask;
+    void *pendingBuffer;
+    gsize pendingCount;
+    GSource *pendingPoll;
+    gint64 pendingDeadline; // g_get_monotonic_time() usecs
+};
+
+struct QIODeviceInputStreamClass
+{
+    GInputStreamClass parentClass;
+};
+
+G_DEFINE_TYPE(QIODeviceInputStream, q_iodevice_input_stream, G_TYPE_INPUT_STREAM)
+
+#define Q_IODEVICE_INPUT_STREAM(object) reinterpret_cast<QIODeviceInputStream *>(object)
+
+// msecs a read waits for a sequential device
+static const int readTimeout = 30000;
+// msecs between checks of a waiting asynchronous read
+static const int pollInterval = 10;
+
+static bool canRead(const QIODeviceInputStream *stream)
+{
+    QIODevice *device = stream->device;
+    return !device->isSequential() || device->bytesAvailable() > 0 || stream->finished
+            || !device->isOpen();
+}
+
+static gssize readDevice(QIODeviceInputStream *stream, void *buffer, gsize count, GError **error)
+{
+    if (!stream->device->isOpen())
+        return 0;
+
+    const qint64 bytesRead = stream->device->read(static_cast<char *>(buffer), qint64(count));
+    if (bytesRead < 0) {
+        g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                            stream->device->errorString().toUtf8().constData());
+        return -1;
+    }
+    return gssize(bytesRead);
+}
+
+static void completeRead(QIODeviceInputStream *stream, GTask *task, void *buffer, gsize count)
+{
+    if (!g_task_return_error_if_cancelled(task)) {
+        GError *error = nullptr;
+        const gssize bytesRead = readDevice(stream, buffer, count, &error);
+        if (bytesRead < 0)
+            g_task_return_error(task, error);
+        else
+            g_task_return_int(task, bytesRead);
+    }
+    g_object_unref(task);
+}
+
+// Completes the waiting read once the device has data, or the read was
+// cancelled or timed out
+static void resumePendingRead(QIODeviceInputStream *stream)
+{
+    GTask *task = stream->pendingTask;
+    if (!task)
+        return;
+    const bool readable = canRead(stream);
+    const bool cancelled = g_cancellable_is_cancelled(g_task_get_cancellable(task));
+    if (!readable && !cancelled && g_get_monotonic_time() < stream->pendingDeadline)
+        return;
+
+    stream->pendingTask = nullptr;
+    g_source_destroy(stream->pendingPoll);
+    g_source_unref(stream->pendingPoll);
+    stream->pendingPoll = nullptr;
+
+    if (!readable && !cancelled) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                                "Timed out waiting for the device to be readable");
+        g_object_unref(task);
+        return;
+    }
+    completeRead(stream, task, stream->pendingBuffer, stream->pendingCount);
+}
+
+static gboolean pollPendingRead(gpointer userData)
+{
+    QIODeviceInputStream *stream = Q_IODEVICE_INPUT_STREAM(g_object_ref(userData));
+    // readyRead() needs a Qt event loop on the thread of the device, which the
+    // GTK thread does not run. There, this is what makes the device read.
+    if (!canRead(stream) && stream->device->thread() == QThread::currentThread())
+        stream->device->waitForReadyRead(0);
+    // Completing the read may drop the last reference elsewhere
+    resumePendingRead(stream);
+    g_object_unref(stream);
+    return G_SOURCE_CONTINUE;
+}
+
+static gssize readSync(GInputStream *base, void *buffer, gsize count, GCancellable *,
+                       GError **error)
+{
+    QIODeviceInputStream *stream = Q_IODEVICE_INPUT_STREAM(base);
+    // No event loop may run on this thread to deliver readyRead(), a stalled
+    // device must not block it for good
+    if (!canRead(stream) && !stream->device->waitForReadyRead(readTimeout) && !canRead(stream)) {
+        g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                            "Timed out waiting for the device to be readable");
+        return -1;
+    }
+    return readDevice(stream, buffer, count, error);
+}
+
+static void readAsync(GInputStream *base, void *buffer, gsize count, int priority,
+                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer userData)
+{
+    QIODeviceInputStream *stream = Q_IODEVICE_INPUT_STREAM(base);
+    GTask *task = g_task_new(base, cancellable, callback, userData);
+    g_task_set_priority(task, priority);
+
+    if (!canRead(stream)) {
+        stream->pendingTask = task;
+        stream->pendingBuffer = buffer;
+        stream->pendingCount = count;
+        stream->pendingDeadline = g_get_monotonic_time() + gint64(readTimeout) * 1000;
+        // Also notices cancellation and the timeout
+        stream->pendingPoll = g_timeout_source_new(pollInterval);
+        g_source_set_priority(stream->pendingPoll, priority);
+        g_source_set_callback(stream->pendingPoll, pollPendingRead, stream, nullptr);
+        g_source_attach(stream->pendingPoll, g_task_get_context(task));
+        return;
+    }
+
+    completeRead(stream, task, buffer, count);
+}
+
+static gssize readFinish(GInputStream *, GAsyncResult *result, GError **error)
+{
+    return g_task_propagate_int(G_TASK(result), error);
+}
+
+static gboolean closeSync(GInputStream *base, GCancellable *, GError **)
+{
+    Q_IODEVICE_INPUT_STREAM(base)->device->close();
+    return TRUE;
+}
+
+// The default implementations would close on a worker thread
+static void closeAsync(GInputStream *base, int priority, GCancellable *cancellable,
+                       GAsyncReadyCallback callback, gpointer userData)
+{
+    GTask *task = g_task_new(base, cancellable, callback, userData);
+    g_task_set_priority(task, priority);
+    Q_IODEVICE_INPUT_STREAM(base)->device->close();
+    g_task_return_boolean(task, TRUE);
+    g_object_unref(task);
+}
+
+static gboolean closeFinish(GInputStream *, GAsyncResult *result, GError **error)
+{
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+static void finalize(GObject *object)
+{
+    QIODeviceInputStream *stream = Q_IODEVICE_INPUT_STREAM(object);
+    delete stream->notifier;
+    delete stream->device;
+
+    G_OBJECT_CLASS(q_iodevice_input_stream_parent_class)->finalize(object);
+}
+
+static void q_iodevice_input_stream_init(QIODeviceInputStream *) { }
+
+static void q_iodevice_input_stream_class_init(QIODeviceInputStreamClass *klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = finalize;
+
+    GInputStreamClass *streamClass = G_INPUT_STREAM_CLASS(klass);
+    streamClass->read_fn = readSync;
+    streamClass->read_async = readAsync;
+    streamClass->read_finish = readFinish;
+    streamClass->close_fn = closeSync;
+    streamClass->close_async = closeAsync;
+    streamClass->close_finish = closeFinish;
+}
+
+GInputStream *q_iodevice_input_stream_new(QIODevice *device)
+{
+    QIODeviceInputStream *stream = Q_IODEVICE_INPUT_STREAM(
+            g_object_new(q_iodevice_input_stream_get_type(), nullptr));
+    stream->device = device;
+    stream->notifier = new QObject;
+
+    // Sequential devices are expected to emit readChannelFinished() or to
+    // close once all of their data has been delivered.
+    QObject::connect(device, &QIODevice::readyRead, stream->notifier,
+                     [stream]() { resumePendingRead(stream); });
+    QObject::connect(device, &QIODevice::readChannelFinished, stream->notifier, [stream]() {
+        stream->finished = true;
+        resumePendingRead(stream);
+    });
+    QObject::connect(device, &QIODevice::aboutToClose, stream->notifier, [stream]() {
+        stream->finished = true;
+        resumePendingRead(stream);
+    });
+
+    return G_INPUT_STREAM(stream);
+}
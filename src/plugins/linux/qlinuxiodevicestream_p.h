@@ -0,0 +1,36 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXIODEVICESTREAM_P_H
+#define QLINUXIODEVICESTREAM_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+#include <gio/gio.h>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+// GInputStream reading from a QIODevice. The device is read on the thread
+// WebKit reads the stream from, the GTK thread, which is where URL scheme
+// handlers create it. Asynchronous reads of sequential devices wait for
+// readyRead() instead of blocking a worker thread, so only one chunk is ever
+// held in memory. Without a Qt event loop on that thread a source polls the
+// device instead. Waiting reads fail with G_IO_ERROR_CANCELLED when cancelled,
+// and with G_IO_ERROR_TIMED_OUT after 30 s. The stream takes ownership of the
+// device.
+GInputStream *q_iodevice_input_stream_new(QT_PREPEND_NAMESPACE(QIODevice) *device);
+
+#endif // QLINUXIODEVICESTREAM_P_H
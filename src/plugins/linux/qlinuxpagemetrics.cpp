@@ -0,0 +1,170 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxpagemetrics_p.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxuserscripts_p.h"
+#include <qwebviewtrace_p.h>
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+
+QT_BEGIN_NAMESPACE
+
+static const char scriptMessageHandlerName[] = "qtpagemetrics";
+
+// Paint timing and long tasks are only reported where the engine supports the
+// entry types, the corresponding values stay at -1 otherwise. Each document
+// announces a random token first, its metrics carry the token and its url.
+static const char metricsScript[] =
+        "(function() {"
+        "    var handler = window.webkit && window.webkit.messageHandlers.qtpagemetrics;"
+        "    if (!handler)"
+        "        return;"
+        "    var token = Math.random().toString(36).slice(2) + Date.now().toString(36);"
+        "    handler.postMessage(JSON.stringify({ document: token }));"
+        "    var metrics = { document: token, firstPaint: -1, firstContentfulPaint: -1,"
+        "                    domContentLoaded: -1, loadEvent: -1, longTaskCount: -1,"
+        "                    longTaskDuration: 0 };"
+        "    var supported = (window.PerformanceObserver"
+        "                     && PerformanceObserver.supportedEntryTypes) || [];"
+        "    function observe(type, callback) {"
+        "        if (supported.indexOf(type) < 0)"
+        "            return false;"
+        "        new PerformanceObserver(function(list) {"
+        "            list.getEntries().forEach(callback);"
+        "        }).observe({ type: type, buffered: true });"
+        "        return true;"
+        "    }"
+        "    observe('paint', function(entry) {"
+        "        if (entry.name === 'first-paint')"
+        "            metrics.firstPaint = entry.startTime;"
+        "        else if (entry.name === 'first-contentful-paint')"
+        "            metrics.firstContentfulPaint = entry.startTime;"
+        "    });"
+        "    if (observe('longtask', function(entry) {"
+        "            metrics.longTaskCount++;"
+        "            metrics.longTaskDuration += entry.duration;"
+        "        }))"
+        "        metrics.longTaskCount = 0;"
+        "    window.addEventListener('load', function() {"
+        "        setTimeout(function() {"
+        "            var navigation = performance.getEntriesByType"
+        "                    && performance.getEntriesByType('navigation')[0];"
+        "            if (navigation) {"
+        "                metrics.domContentLoaded = navigation.domContentLoadedEventEnd;"
+        "                metrics.loadEvent = navigation.loadEventEnd;"
+        "            } else {"
+        "                var timing = performance.timing;"
+        "                metrics.domContentLoaded ="
+        "                        timing.domContentLoadedEventEnd - timing.navigationStart;"
+        "                metrics.loadEvent = timing.loadEventEnd - timing.navigationStart;"
+        "            }"
+        "            metrics.url = location.href;"
+        "            handler.postMessage(JSON.stringify(metrics));"
+        "        }, 0);"
+        "    });"
+        "})();";
+
+// Documents announced but not reported yet. Pages left before their load
+// event never report, the oldest are dropped.
+static const int maximumPendingDocuments = 8;
+
+QLinuxPageMetricsObserver::QLinuxPageMetricsObserver(void *webview,
+                                                     std::function<quint64()> navigationId,
+                                                     QObject *parent)
+    : QObject(parent),
+      m_contentManager(nullptr),
+      m_userScript(nullptr),
+      m_navigationId(std::move(navigationId))
+{
+    QLinuxGtkThread::invoke([this, webview]() {
+        WebKitUserContentManager *manager =
+                webkit_web_view_get_user_content_manager(static_cast<WebKitWebView *>(webview));
+        m_contentManager = g_object_ref(manager);
+
+        m_handlerId = g_signal_connect_swapped(
+                manager, "script-message-received::qtpagemetrics",
+                G_CALLBACK(+[](QLinuxPageMetricsObserver *instance,
+                               WebKitJavascriptResult *result) {
+                    instance->scriptMessageReceived(result);
+                }),
+                this);
+        webkit_user_content_manager_register_script_message_handler(manager,
+                                                                    scriptMessageHandlerName);
+
+        // Applies from the next navigation on, the current one has started already
+        WebKitUserScript *userScript = webkit_user_script_new(
+                metricsScript, WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+        QLinuxUserScripts::add(manager, userScript);
+        m_userScript = userScript;
+    });
+}
+
+QLinuxPageMetricsObserver::~QLinuxPageMetricsObserver()
+{
+    QLinuxGtkThread::invoke([this]() {
+        WebKitUserContentManager *manager =
+                static_cast<WebKitUserContentManager *>(m_contentManager);
+        g_signal_handler_disconnect(manager, m_handlerId);
+        webkit_user_content_manager_unregister_script_message_handler(manager,
+                                                                      scriptMessageHandlerName);
+
+        QLinuxUserScripts::remove(manager, m_userScript);
+        webkit_user_script_unref(static_cast<WebKitUserScript *>(m_userScript));
+        g_object_unref(manager);
+    });
+}
+
+void QLinuxPageMetricsObserver::scriptMessageReceived(void *jsResult)
+{
+    Q_WEBVIEW_TRACE_SPAN("QLinuxPageMetricsObserver::scriptMessageReceived");
+    JSCValue *value =
+            webkit_javascript_result_get_js_value(static_cast<WebKitJavascriptResult *>(jsResult));
+    if (!jsc_value_is_string(value))
+        return;
+
+    gchar *data = jsc_value_to_string(value);
+    const QJsonObject object = QJsonDocument::fromJson(QByteArray(data)).object();
+    g_free(data);
+
+    const QString token = object.value(QLatin1String("document")).toString();
+    if (token.isEmpty()) {
+        qWarning() << "Invalid page metrics message";
+        return;
+    }
+
+    // Sent at document start, which follows the commit of its navigation
+    if (object.size() == 1) {
+        if (m_documents.size() == maximumPendingDocuments)
+            m_documents.removeFirst();
+        m_documents.append(qMakePair(token, m_navigationId()));
+        return;
+    }
+
+    QWebViewPageMetrics metrics;
+    for (int i = 0; i < m_documents.size(); ++i) {
+        if (m_documents.at(i).first == token) {
+            metrics.navigationId = m_documents.at(i).second;
+            m_documents.removeAt(i);
+            break;
+        }
+    }
+    metrics.url = QUrl(object.value(QLatin1String("url")).toString());
+    metrics.firstPaint = object.value(QLatin1String("firstPaint")).toDouble(-1);
+    metrics.firstContentfulPaint =
+            object.value(QLatin1String("firstContentfulPaint")).toDouble(-1);
+    metrics.domContentLoaded = object.value(QLatin1String("domContentLoaded")).toDouble(-1);
+    metrics.loadEvent = object.value(QLatin1String("loadEvent")).toDouble(-1);
+    metrics.longTaskCount = object.value(QLatin1String("longTaskCount")).toInt(-1);
+    metrics.longTaskDuration = object.value(QLatin1String("longTaskDuration")).toDouble();
+    QLinuxGtkThread::deliver(this, [this, metrics]() { emit metricsReceived(metrics); });
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,57 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXPAGEMETRICS_P_H
+#define QLINUXPAGEMETRICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <qwebviewpagemetrics_p.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qvector.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+// Injects a PerformanceObserver script at document start and reports its
+// numbers through the "qtpagemetrics" script message handler.
+class QLinuxPageMetricsObserver : public QObject
+{
+    Q_OBJECT
+public:
+    // navigationId is called on the GTK thread when a document starts and
+    // returns the navigation that committed it, 0 for none.
+    QLinuxPageMetricsObserver(void *webview, std::function<quint64()> navigationId,
+                              QObject *parent = nullptr);
+    ~QLinuxPageMetricsObserver() override;
+
+Q_SIGNALS:
+    // navigationId is 0 when the document is not known
+    void metricsReceived(const QWebViewPageMetrics &metrics);
+
+private:
+    void scriptMessageReceived(void *jsResult);
+
+    void *m_contentManager; // WebKitUserContentManager
+    void *m_userScript; // WebKitUserScript
+    unsigned long m_handlerId = 0;
+    std::function<quint64()> m_navigationId;
+    // Token and navigation of the started documents. GTK thread only.
+    QVector<QPair<QString, quint64>> m_documents;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLINUXPAGEMETRICS_P_H
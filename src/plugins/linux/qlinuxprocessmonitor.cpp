@@ -0,0 +1,300 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qlinuxprocessmonitor_p.h"
+#include "qlinuxwebview_p.h"
+#include <qwebviewloadrequest_p.h>
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qset.h>
+
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct ProcessStat
+{
+    qint64 pid = 0;
+    qint64 parentPid = 0;
+    QByteArray name;
+    qint64 cpuTicks = 0; // utime + stime
+    qint64 startTime = 0; // clock ticks after boot
+};
+} // namespace
+
+static QByteArray readProcFile(qint64 pid, const char *name)
+{
+    QFile file(QStringLiteral("/proc/%1/%2").arg(pid).arg(QLatin1String(name)));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+static bool readProcessStat(qint64 pid, ProcessStat *stat)
+{
+    // The name may contain spaces and parentheses, the fields follow its last ')'
+    const QByteArray content = readProcFile(pid, "stat");
+    const int nameStart = content.indexOf('(');
+    const int nameEnd = content.lastIndexOf(')');
+    if (nameStart < 0 || nameEnd < nameStart)
+        return false;
+
+    const QList<QByteArray> fields = content.mid(nameEnd + 2).split(' ');
+    // Fields from the state (3) on, see proc(5)
+    if (fields.size() < 20)
+        return false;
+    stat->pid = pid;
+    stat->name = content.mid(nameStart + 1, nameEnd - nameStart - 1);
+    stat->parentPid = fields.at(1).toLongLong();
+    stat->cpuTicks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    stat->startTime = fields.at(19).toLongLong();
+    return true;
+}
+
+// Web processes started by this process, through bwrap when sandboxed
+static QList<ProcessStat> webProcesses()
+{
+    QHash<qint64, ProcessStat> processes;
+    const QStringList entries = QDir(QStringLiteral("/proc")).entryList(QDir::Dirs);
+    for (const QString &entry : entries) {
+        bool isPid = false;
+        const qint64 pid = entry.toLongLong(&isPid);
+        ProcessStat stat;
+        if (isPid && readProcessStat(pid, &stat))
+            processes.insert(pid, stat);
+    }
+
+    const qint64 ownPid = getpid();
+    QList<ProcessStat> result;
+    const QHash<qint64, ProcessStat> &allProcesses = processes;
+    for (const ProcessStat &process : allProcesses) {
+        // The name is cut to 15 characters
+        if (!process.name.startsWith("WebKitWebProces"))
+            continue;
+        qint64 ancestor = process.parentPid;
+        while (ancestor > 1 && ancestor != ownPid && processes.contains(ancestor))
+            ancestor = processes.value(ancestor).parentPid;
+        if (ancestor == ownPid)
+            result.append(process);
+    }
+    return result;
+}
+
+static qint64 proportionalBytes(qint64 pid)
+{
+    const QByteArray rollup = readProcFile(pid, "smaps_rollup");
+    const int start = rollup.indexOf("\nPss:");
+    if (start < 0)
+        return -1;
+    const int end = rollup.indexOf('\n', start + 1);
+    const QByteArray value = rollup.mid(start + 5, end - start - 5).trimmed();
+    // "1234 kB"
+    return value.left(value.indexOf(' ')).toLongLong() * 1024;
+}
+
+static qint64 residentBytes(qint64 pid)
+{
+    const QList<QByteArray> fields = readProcFile(pid, "statm").split(' ');
+    if (fields.size() < 2)
+        return -1;
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    return fields.at(1).toLongLong() * pageSize;
+}
+
+QLinuxProcessMonitor::QLinuxProcessMonitor(QObject *parent) : QObject(parent)
+{
+    qRegisterMetaType<QLinuxProcessSample>();
+
+    const int interval = qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_MONITOR_INTERVAL");
+    m_timer.setInterval(interval > 0 ? interval : 5000);
+    connect(&m_timer, &QTimer::timeout, this, &QLinuxProcessMonitor::sampleNow);
+
+    // WebKit starts the process of a cross-site navigation around the commit
+    m_claimTimer.setSingleShot(true);
+    m_claimTimer.setInterval(250);
+    connect(&m_claimTimer, &QTimer::timeout, this, &QLinuxProcessMonitor::claimProcesses);
+}
+
+QLinuxProcessMonitor::~QLinuxProcessMonitor()
+{
+    const QHash<QAbstractWebView *, ViewEntry> &views = m_views;
+    for (const ViewEntry &entry : views) {
+        for (const QMetaObject::Connection &connection : entry.connections)
+            disconnect(connection);
+    }
+}
+
+void QLinuxProcessMonitor::addView(QAbstractWebView *view)
+{
+    if (!qobject_cast<QLinuxWebViewPrivate *>(view)) {
+        qWarning("QLinuxProcessMonitor: only views of the Linux backend can be monitored");
+        return;
+    }
+    if (m_views.contains(view))
+        return;
+
+    ViewEntry &entry = m_views[view];
+    entry.connections.append(connect(view, &QAbstractWebView::loadingChanged, this,
+                                     [this, view](const QWebViewLoadRequestPrivate &request) {
+                                         if (request.m_status == QWebView::LoadCommittedStatus)
+                                             scheduleClaim(view);
+                                     }));
+    entry.connections.append(connect(view, &QObject::destroyed, this,
+                                     [this, view]() {
+                                         m_views.remove(view);
+                                         m_pendingClaims.removeAll(view);
+                                         if (m_views.isEmpty())
+                                             m_timer.stop();
+                                     }));
+
+    // The view may have loaded before it was added
+    scheduleClaim(view);
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void QLinuxProcessMonitor::removeView(QAbstractWebView *view)
+{
+    const auto entry = m_views.find(view);
+    if (entry == m_views.end())
+        return;
+    for (const QMetaObject::Connection &connection : entry->connections)
+        disconnect(connection);
+    m_views.erase(entry);
+    m_pendingClaims.removeAll(view);
+    if (m_views.isEmpty())
+        m_timer.stop();
+}
+
+QLinuxProcessSample QLinuxProcessMonitor::sample(QAbstractWebView *view) const
+{
+    return m_views.value(view).sample;
+}
+
+qint64 QLinuxProcessMonitor::processId(QAbstractWebView *view) const
+{
+    return m_views.value(view).sample.pid;
+}
+
+void QLinuxProcessMonitor::setInterval(int msecs)
+{
+    m_timer.setInterval(qMax(1, msecs));
+}
+
+void QLinuxProcessMonitor::scheduleClaim(QAbstractWebView *view)
+{
+    if (!m_pendingClaims.contains(view))
+        m_pendingClaims.append(view);
+    if (!m_claimTimer.isActive())
+        m_claimTimer.start();
+}
+
+void QLinuxProcessMonitor::claimProcesses()
+{
+    const QList<ProcessStat> processes = webProcesses();
+    // Emitting may add or remove views
+    const QList<QAbstractWebView *> views = m_pendingClaims;
+    m_pendingClaims.clear();
+    for (QAbstractWebView *view : views) {
+        const auto entry = m_views.find(view);
+        if (entry == m_views.end())
+            continue;
+
+        QSet<qint64> claimed;
+        for (auto it = m_views.cbegin(); it != m_views.cend(); ++it) {
+            if (it.key() != view && it->sample.pid)
+                claimed.insert(it->sample.pid);
+        }
+
+        const ProcessStat *newest = nullptr;
+        const ProcessStat *newestShared = nullptr;
+        const ProcessStat *own = nullptr;
+        for (const ProcessStat &process : processes) {
+            if (process.pid == entry->sample.pid) {
+                own = &process;
+                continue;
+            }
+            const ProcessStat *&candidate =
+                    claimed.contains(process.pid) ? newestShared : newest;
+            if (!candidate || process.startTime > candidate->startTime)
+                candidate = &process;
+        }
+
+        // A process started after the view's own, by a cross-site navigation, replaces it
+        if (newest && (!own || newest->startTime > own->startTime))
+            setProcessId(view, *entry, newest->pid);
+        else if (!own)
+            setProcessId(view, *entry, newestShared ? newestShared->pid : 0);
+    }
+}
+
+void QLinuxProcessMonitor::setProcessId(QAbstractWebView *view, ViewEntry &entry, qint64 pid)
+{
+    if (entry.sample.pid == pid)
+        return;
+    entry.sample = QLinuxProcessSample();
+    entry.sample.pid = pid;
+    entry.cpuTicks = -1;
+    entry.residentExceeded = false;
+    entry.cpuExceeded = false;
+    emit processIdChanged(view, pid);
+}
+
+void QLinuxProcessMonitor::sampleNow()
+{
+    // Emitting may remove views
+    const QList<QAbstractWebView *> views = m_views.keys();
+    for (QAbstractWebView *view : views) {
+        const auto entry = m_views.find(view);
+        if (entry != m_views.end())
+            sampleView(view, *entry);
+    }
+}
+
+void QLinuxProcessMonitor::sampleView(QAbstractWebView *view, ViewEntry &entry)
+{
+    if (!entry.sample.pid)
+        return;
+
+    ProcessStat stat;
+    if (!readProcessStat(entry.sample.pid, &stat)) {
+        // Crashed, or replaced and gone; the next commit claims another one
+        setProcessId(view, entry, 0);
+        return;
+    }
+
+    const qint64 now = QDeadlineTimer::current().deadlineNSecs();
+    QLinuxProcessSample sample;
+    sample.pid = entry.sample.pid;
+    sample.residentBytes = residentBytes(sample.pid);
+    sample.proportionalBytes = proportionalBytes(sample.pid);
+    sample.sampledAt = now;
+    if (entry.cpuTicks >= 0 && now > entry.sample.sampledAt) {
+        static const double ticksPerSecond = double(sysconf(_SC_CLK_TCK));
+        const double seconds = (now - entry.sample.sampledAt) / 1e9;
+        sample.cpuUsage = (stat.cpuTicks - entry.cpuTicks) / ticksPerSecond / seconds * 100;
+    }
+    entry.cpuTicks = stat.cpuTicks;
+    entry.sample = sample;
+
+    const bool residentExceeded =
+            m_residentThreshold > 0 && sample.residentBytes > m_residentThreshold;
+    const bool cpuExceeded = m_cpuThreshold > 0 && sample.cpuUsage > m_cpuThreshold;
+    const bool residentCrossed = residentExceeded && !entry.residentExceeded;
+    const bool cpuCrossed = cpuExceeded && !entry.cpuExceeded;
+    entry.residentExceeded = residentExceeded;
+    entry.cpuExceeded = cpuExceeded;
+
+    // entry may be gone once the first signal has been emitted
+    emit sampled(view, sample);
+    if (residentCrossed)
+        emit residentThresholdExceeded(view, sample);
+    if (cpuCrossed)
+        emit cpuThresholdExceeded(view, sample);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,114 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXPROCESSMONITOR_P_H
+#define QLINUXPROCESSMONITOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qtimer.h>
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractWebView;
+class QWebViewLoadRequestPrivate;
+
+struct QLinuxProcessSample
+{
+    qint64 pid = 0; // 0 while the view has no known web process
+    qint64 residentBytes = -1; // RSS, -1 if unknown
+    qint64 proportionalBytes = -1; // PSS, -1 if unknown (before Linux 4.14)
+    double cpuUsage = 0; // percent of one core since the previous sample
+    qint64 sampledAt = 0; // monotonic nsecs
+};
+
+// Samples the memory and CPU use of the web processes of Linux views from
+// /proc, every interval(), which defaults to QT_WEBVIEW_LINUX_MONITOR_INTERVAL
+// or 5 s.
+//
+// WebKit does not tell which web process serves a view. A view claims the
+// newest WebKitWebProcess descendant no other monitored view has claimed
+// when its load commits, and keeps its process while no new one appears.
+// Views loading at the same time may be told apart wrongly, and a view
+// sharing its process with another one only gets it if nothing else is
+// left. Add all views to the same monitor, QLinuxWebViewPlugin::processMonitor().
+//
+// Finding the processes means reading all of /proc, so commits are collected
+// and handled together, claimDelay() after the first one.
+class QLinuxProcessMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QLinuxProcessMonitor(QObject *parent = nullptr);
+    ~QLinuxProcessMonitor() override;
+
+    // view is the backend of a QWebView, from QWebView::get()
+    void addView(QAbstractWebView *view);
+    void removeView(QAbstractWebView *view);
+    QList<QAbstractWebView *> views() const { return m_views.keys(); }
+
+    // The latest sample, a default one for views not monitored
+    QLinuxProcessSample sample(QAbstractWebView *view) const;
+    qint64 processId(QAbstractWebView *view) const;
+
+    int interval() const { return m_timer.interval(); }
+    void setInterval(int msecs);
+    int claimDelay() const { return m_claimTimer.interval(); }
+    void setClaimDelay(int msecs) { m_claimTimer.setInterval(qMax(0, msecs)); }
+
+    // Signals are emitted when a sample goes above a threshold, and again
+    // only after it went back below. 0 disables a threshold.
+    qint64 residentThreshold() const { return m_residentThreshold; }
+    void setResidentThreshold(qint64 bytes) { m_residentThreshold = bytes; }
+    double cpuThreshold() const { return m_cpuThreshold; }
+    void setCpuThreshold(double percent) { m_cpuThreshold = percent; }
+
+public Q_SLOTS:
+    void sampleNow();
+
+Q_SIGNALS:
+    void processIdChanged(QAbstractWebView *view, qint64 pid);
+    void sampled(QAbstractWebView *view, const QLinuxProcessSample &sample);
+    void residentThresholdExceeded(QAbstractWebView *view, const QLinuxProcessSample &sample);
+    void cpuThresholdExceeded(QAbstractWebView *view, const QLinuxProcessSample &sample);
+
+private:
+    struct ViewEntry
+    {
+        QLinuxProcessSample sample;
+        qint64 cpuTicks = -1; // utime + stime at the previous sample
+        bool residentExceeded = false;
+        bool cpuExceeded = false;
+        QList<QMetaObject::Connection> connections;
+    };
+
+    void scheduleClaim(QAbstractWebView *view);
+    void claimProcesses();
+    void setProcessId(QAbstractWebView *view, ViewEntry &entry, qint64 pid);
+    void sampleView(QAbstractWebView *view, ViewEntry &entry);
+
+    QHash<QAbstractWebView *, ViewEntry> m_views;
+    QTimer m_timer;
+    QTimer m_claimTimer;
+    QList<QAbstractWebView *> m_pendingClaims; // committed since the last claim
+    qint64 m_residentThreshold = 0;
+    double m_cpuThreshold = 0;
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QLinuxProcessSample)
+
+#endif // QLINUXPROCESSMONITOR_P_H
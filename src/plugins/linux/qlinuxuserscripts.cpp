@@ -0,0 +1,51 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxuserscripts_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+#if !WEBKIT_CHECK_VERSION(2, 32, 0)
+// Scripts added through this class, by content manager
+static QHash<void *, QList<void *>> &registeredScripts()
+{
+    static QHash<void *, QList<void *>> scripts;
+    return scripts;
+}
+#endif
+
+void QLinuxUserScripts::add(void *contentManager, void *userScript)
+{
+    webkit_user_content_manager_add_script(
+            static_cast<WebKitUserContentManager *>(contentManager),
+            static_cast<WebKitUserScript *>(userScript));
+#if !WEBKIT_CHECK_VERSION(2, 32, 0)
+    registeredScripts()[contentManager].append(userScript);
+#endif
+}
+
+void QLinuxUserScripts::remove(void *contentManager, void *userScript)
+{
+    WebKitUserContentManager *manager = static_cast<WebKitUserContentManager *>(contentManager);
+#if WEBKIT_CHECK_VERSION(2, 32, 0)
+    webkit_user_content_manager_remove_script(manager, static_cast<WebKitUserScript *>(userScript));
+#else
+    QHash<void *, QList<void *>> &scripts = registeredScripts();
+    QList<void *> &remaining = scripts[contentManager];
+    remaining.removeOne(userScript);
+    webkit_user_content_manager_remove_all_scripts(manager);
+    for (void *script : remaining)
+        webkit_user_content_manager_add_script(manager, static_cast<WebKitUserScript *>(script));
+    if (remaining.isEmpty())
+        scripts.remove(contentManager);
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,35 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXUSERSCRIPTS_P_H
+#define QLINUXUSERSCRIPTS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+// User scripts shared by the features of a WebKitUserContentManager. WebKit
+// before 2.32 can only remove all scripts at once, the scripts of the other
+// features are added back then. GTK thread only.
+class QLinuxUserScripts
+{
+public:
+    // contentManager is a WebKitUserContentManager, userScript a WebKitUserScript
+    static void add(void *contentManager, void *userScript);
+    static void remove(void *contentManager, void *userScript);
+};
+
+QT_END_NAMESPACE
+
+#endif // QLINUXUSERSCRIPTS_P_H
@@ -0,0 +1,148 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxwebchanneltransport_p.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxuserscripts_p.h"
+#include <qwebviewtrace_p.h>
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+
+QT_BEGIN_NAMESPACE
+
+static const char scriptMessageHandlerName[] = "qtwebchannel";
+
+static const char transportScript[] =
+        "(function() {"
+        "    if (navigator.qtWebChannelTransport)"
+        "        return;"
+        "    var transport = {"
+        "        send: function(data) {"
+        "            if (typeof data !== 'string')"
+        "                data = JSON.stringify(data);"
+        "            window.webkit.messageHandlers.qtwebchannel.postMessage(data);"
+        "        },"
+        "        onmessage: null"
+        "    };"
+        "    Object.defineProperty(navigator, 'qtWebChannelTransport', { value: transport });"
+        "})();\n";
+
+static QByteArray bootstrapScript()
+{
+    QByteArray script = transportScript;
+
+    // Shipped as a resource of the Qt WebChannel library
+    QFile file(QStringLiteral(":/qtwebchannel/qwebchannel.js"));
+    if (file.open(QIODevice::ReadOnly))
+        script += file.readAll();
+    else
+        qWarning() << "qwebchannel.js not found, pages have to provide it themselves";
+
+    return script;
+}
+
+QLinuxWebChannelTransport::QLinuxWebChannelTransport(void *webview, QObject *parent)
+    : QWebChannelAbstractTransport(parent),
+      m_webview(webview),
+      m_contentManager(nullptr),
+      m_userScript(nullptr)
+{
+    // Read here, resources are not to be touched from the GTK thread
+    const QByteArray script = bootstrapScript();
+
+    QLinuxGtkThread::invoke([this, &script]() {
+        WebKitWebView *view = static_cast<WebKitWebView *>(m_webview);
+        WebKitUserContentManager *manager = webkit_web_view_get_user_content_manager(view);
+        // Keep the manager alive until we have unregistered, the view may go first
+        m_contentManager = g_object_ref(manager);
+
+        m_handlerId = g_signal_connect_swapped(
+                manager, "script-message-received::qtwebchannel",
+                G_CALLBACK(+[](QLinuxWebChannelTransport *instance,
+                               WebKitJavascriptResult *result) {
+                    instance->scriptMessageReceived(result);
+                }),
+                this);
+        webkit_user_content_manager_register_script_message_handler(manager,
+                                                                    scriptMessageHandlerName);
+
+        WebKitUserScript *userScript = webkit_user_script_new(
+                script.constData(), WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+        QLinuxUserScripts::add(manager, userScript);
+        m_userScript = userScript;
+
+        // The user script applies from the next navigation on, cover the current document too
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+        webkit_web_view_evaluate_javascript(view, script.constData(), script.size(), nullptr,
+                                            nullptr, nullptr, nullptr, nullptr);
+#else
+        webkit_web_view_run_javascript(view, script.constData(), nullptr, nullptr, nullptr);
+#endif
+    });
+}
+
+QLinuxWebChannelTransport::~QLinuxWebChannelTransport()
+{
+    QLinuxGtkThread::invoke([this]() {
+        WebKitUserContentManager *manager =
+                static_cast<WebKitUserContentManager *>(m_contentManager);
+        g_signal_handler_disconnect(manager, m_handlerId);
+        webkit_user_content_manager_unregister_script_message_handler(manager,
+                                                                      scriptMessageHandlerName);
+
+        QLinuxUserScripts::remove(manager, m_userScript);
+        webkit_user_script_unref(static_cast<WebKitUserScript *>(m_userScript));
+        g_object_unref(manager);
+    });
+}
+
+void QLinuxWebChannelTransport::sendMessage(const QJsonObject &message)
+{
+    // JSON is a valid object literal, qwebchannel.js accepts objects as well as strings
+    const QByteArray script = "if (navigator.qtWebChannelTransport"
+                              " && navigator.qtWebChannelTransport.onmessage)"
+                              " navigator.qtWebChannelTransport.onmessage({ data: "
+            + QJsonDocument(message).toJson(QJsonDocument::Compact) + " });";
+
+    WebKitWebView *view = static_cast<WebKitWebView *>(m_webview);
+    QLinuxGtkThread::post([view, script]() {
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+        webkit_web_view_evaluate_javascript(view, script.constData(), script.size(), nullptr,
+                                            nullptr, nullptr, nullptr, nullptr);
+#else
+        webkit_web_view_run_javascript(view, script.constData(), nullptr, nullptr, nullptr);
+#endif
+    });
+}
+
+void QLinuxWebChannelTransport::scriptMessageReceived(void *jsResult)
+{
+    Q_WEBVIEW_TRACE_SPAN("QLinuxWebChannelTransport::scriptMessageReceived");
+    JSCValue *value =
+            webkit_javascript_result_get_js_value(static_cast<WebKitJavascriptResult *>(jsResult));
+    if (!jsc_value_is_string(value))
+        return;
+
+    gchar *data = jsc_value_to_string(value);
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(QByteArray(data), &error);
+    g_free(data);
+
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Invalid web channel message:" << error.errorString();
+        return;
+    }
+
+    const QJsonObject message = document.object();
+    QLinuxGtkThread::deliver(this, [this, message]() { emit messageReceived(message, this); });
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,44 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXWEBCHANNELTRANSPORT_P_H
+#define QLINUXWEBCHANNELTRANSPORT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtWebChannel/qwebchannelabstracttransport.h>
+
+QT_BEGIN_NAMESPACE
+
+// Page side: navigator.qtWebChannelTransport, backed by the "qtwebchannel"
+// script message handler. qwebchannel.js is injected at document start.
+class QLinuxWebChannelTransport : public QWebChannelAbstractTransport
+{
+    Q_OBJECT
+public:
+    explicit QLinuxWebChannelTransport(void *webview, QObject *parent = nullptr);
+    ~QLinuxWebChannelTransport() override;
+
+    void sendMessage(const QJsonObject &message) override;
+
+private:
+    void scriptMessageReceived(void *jsResult);
+
+    void *m_webview; // WebKitWebView
+    void *m_contentManager; // WebKitUserContentManager
+    void *m_userScript; // WebKitUserScript
+    unsigned long m_handlerId = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLINUXWEBCHANNELTRANSPORT_P_H
@@ -0,0 +1,319 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxwebcontext_p.h"
+#include "qlinuxcookiestore_p.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxiodevicestream_p.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qmimedatabase.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qurl.h>
+
+QT_BEGIN_NAMESPACE
+
+#if !WEBKIT_CHECK_VERSION(2, 26, 0)
+static WebKitProcessModel toWebKitProcessModel(QLinuxWebContext::ProcessModel model)
+{
+    switch (model) {
+    case QLinuxWebContext::SharedSecondaryProcess:
+        return WEBKIT_PROCESS_MODEL_SHARED_SECONDARY_PROCESS;
+    case QLinuxWebContext::MultipleSecondaryProcesses:
+        break;
+    }
+    return WEBKIT_PROCESS_MODEL_MULTIPLE_SECONDARY_PROCESSES;
+}
+#endif
+
+static WebKitCacheModel toWebKitCacheModel(QLinuxWebContext::CacheModel model)
+{
+    switch (model) {
+    case QLinuxWebContext::DocumentViewerCacheModel:
+        return WEBKIT_CACHE_MODEL_DOCUMENT_VIEWER;
+    case QLinuxWebContext::DocumentBrowserCacheModel:
+        return WEBKIT_CACHE_MODEL_DOCUMENT_BROWSER;
+    case QLinuxWebContext::WebBrowserCacheModel:
+        break;
+    }
+    return WEBKIT_CACHE_MODEL_WEB_BROWSER;
+}
+
+static void finishWithError(WebKitURISchemeRequest *request, GIOErrorEnum code,
+                            const QString &message)
+{
+    GError *error = g_error_new_literal(G_IO_ERROR, code, message.toUtf8().constData());
+    webkit_uri_scheme_request_finish_error(request, error);
+    g_error_free(error);
+}
+
+static void urlSchemeRequested(WebKitURISchemeRequest *request, gpointer userData)
+{
+    const QLinuxUrlSchemeHandler &handler = *static_cast<QLinuxUrlSchemeHandler *>(userData);
+    const QUrl url(QString::fromUtf8(webkit_uri_scheme_request_get_uri(request)));
+
+    QByteArray mimeType;
+    QIODevice *device = handler(url, &mimeType);
+    if (!device) {
+        finishWithError(request, G_IO_ERROR_NOT_FOUND, url.toString());
+        return;
+    }
+    if (!device->isOpen() && !device->open(QIODevice::ReadOnly)) {
+        finishWithError(request, G_IO_ERROR_FAILED, device->errorString());
+        delete device;
+        return;
+    }
+
+    if (mimeType.isEmpty())
+        mimeType = QMimeDatabase().mimeTypeForUrl(url).name().toUtf8();
+
+    // WebKit pulls the body chunk by chunk, nothing is buffered up front
+    const gint64 length = device->isSequential() ? -1 : device->size() - device->pos();
+    GInputStream *stream = q_iodevice_input_stream_new(device);
+    webkit_uri_scheme_request_finish(request, stream, length, mimeType.constData());
+    g_object_unref(stream);
+}
+
+QLinuxWebContext::QLinuxWebContext(QObject *parent) : QObject(parent) { }
+
+QLinuxWebContext::~QLinuxWebContext()
+{
+    delete m_cookieStore;
+    void *context = m_context;
+    void *dataManager = m_dataManager;
+    QLinuxGtkThread::post([context, dataManager]() {
+        if (context)
+            g_object_unref(context);
+        if (dataManager)
+            g_object_unref(dataManager);
+    });
+}
+
+QLinuxWebContext::ProcessModel QLinuxWebContext::processModel() const
+{
+    return m_processModel;
+}
+
+void QLinuxWebContext::setProcessModel(ProcessModel model)
+{
+    m_processModel = model;
+#if !WEBKIT_CHECK_VERSION(2, 26, 0)
+    // Only honored by WebKit until the first web process has been launched
+    if (m_context) {
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        webkit_web_context_set_process_model(static_cast<WebKitWebContext *>(m_context),
+                                             toWebKitProcessModel(model));
+        G_GNUC_END_IGNORE_DEPRECATIONS
+    }
+#endif
+}
+
+uint QLinuxWebContext::webProcessCountLimit() const
+{
+    return m_webProcessCountLimit;
+}
+
+void QLinuxWebContext::setWebProcessCountLimit(uint limit)
+{
+    m_webProcessCountLimit = limit;
+#if !WEBKIT_CHECK_VERSION(2, 26, 0)
+    if (m_context) {
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        webkit_web_context_set_web_process_count_limit(
+                static_cast<WebKitWebContext *>(m_context), limit);
+        G_GNUC_END_IGNORE_DEPRECATIONS
+    }
+#endif
+}
+
+QLinuxWebContext::CacheModel QLinuxWebContext::cacheModel() const
+{
+    return m_cacheModel;
+}
+
+void QLinuxWebContext::setCacheModel(CacheModel model)
+{
+    m_cacheModel = model;
+    if (m_context)
+        webkit_web_context_set_cache_model(static_cast<WebKitWebContext *>(m_context),
+                                           toWebKitCacheModel(model));
+}
+
+QString QLinuxWebContext::cookieStoragePath() const
+{
+    return m_cookieStoragePath;
+}
+
+void QLinuxWebContext::setCookieStoragePath(const QString &path)
+{
+    m_cookieStoragePath = path;
+    if (!path.isEmpty())
+        QDir().mkpath(QFileInfo(path).absolutePath());
+    if (m_cookieStore && !path.isEmpty())
+        m_cookieStore->setPersistentStorage(path,
+                                            path.endsWith(QLatin1String(".txt"))
+                                                    ? QLinuxCookieStore::TextStorage
+                                                    : QLinuxCookieStore::SqliteStorage);
+}
+
+QString QLinuxWebContext::defaultCookieStoragePath()
+{
+    const QString location = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return location.isEmpty() ? QString()
+                              : QDir(location).filePath(QStringLiteral("cookies.sqlite"));
+}
+
+QLinuxCookieStore *QLinuxWebContext::cookieStore()
+{
+    handle();
+    return m_cookieStore;
+}
+
+void QLinuxWebContext::registerUrlScheme(const QByteArray &scheme,
+                                         const QLinuxUrlSchemeHandler &handler,
+                                         UrlSchemeFlags flags)
+{
+    const QList<UrlScheme> &urlSchemes = m_urlSchemes;
+    for (const UrlScheme &urlScheme : urlSchemes) {
+        if (urlScheme.scheme == scheme) {
+            qWarning() << "URL scheme" << scheme << "is already registered";
+            return;
+        }
+    }
+
+    const UrlScheme urlScheme{ scheme, handler, flags };
+    m_urlSchemes.append(urlScheme);
+    if (m_context)
+        installUrlScheme(urlScheme);
+}
+
+void QLinuxWebContext::installUrlScheme(const UrlScheme &urlScheme)
+{
+    WebKitWebContext *context = static_cast<WebKitWebContext *>(m_context);
+    webkit_web_context_register_uri_scheme(
+            context, urlScheme.scheme.constData(), urlSchemeRequested,
+            new QLinuxUrlSchemeHandler(urlScheme.handler),
+            [](gpointer handler) { delete static_cast<QLinuxUrlSchemeHandler *>(handler); });
+
+    WebKitSecurityManager *security = webkit_web_context_get_security_manager(context);
+    if (urlScheme.flags & SecureScheme)
+        webkit_security_manager_register_uri_scheme_as_secure(security,
+                                                              urlScheme.scheme.constData());
+    if (urlScheme.flags & CorsEnabledScheme)
+        webkit_security_manager_register_uri_scheme_as_cors_enabled(security,
+                                                                    urlScheme.scheme.constData());
+    if (urlScheme.flags & LocalScheme)
+        webkit_security_manager_register_uri_scheme_as_local(security,
+                                                             urlScheme.scheme.constData());
+}
+
+void QLinuxWebContext::setWebsiteDataManager(void *manager)
+{
+    if (m_context) {
+        qWarning("The website data manager cannot be changed once the context exists");
+        return;
+    }
+    if (manager)
+        g_object_ref(manager);
+    if (m_dataManager)
+        g_object_unref(m_dataManager);
+    m_dataManager = manager;
+}
+
+void *QLinuxWebContext::handle()
+{
+    if (!m_context) {
+        WebKitWebContext *context = m_dataManager
+                ? webkit_web_context_new_with_website_data_manager(
+                          static_cast<WebKitWebsiteDataManager *>(m_dataManager))
+                : webkit_web_context_new();
+#if !WEBKIT_CHECK_VERSION(2, 26, 0)
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        webkit_web_context_set_process_model(context, toWebKitProcessModel(m_processModel));
+        webkit_web_context_set_web_process_count_limit(context, m_webProcessCountLimit);
+        G_GNUC_END_IGNORE_DEPRECATIONS
+#endif
+        webkit_web_context_set_cache_model(context, toWebKitCacheModel(m_cacheModel));
+        m_context = context;
+
+        // This may run on the GTK thread, the store belongs with the context regardless
+        m_cookieStore = new QLinuxCookieStore(webkit_web_context_get_cookie_manager(context),
+                                              webkit_web_context_get_website_data_manager(context));
+        m_cookieStore->moveToThread(thread());
+        setCookieStoragePath(m_cookieStoragePath);
+
+        const QList<UrlScheme> &urlSchemes = m_urlSchemes;
+        for (const UrlScheme &urlScheme : urlSchemes)
+            installUrlScheme(urlScheme);
+    }
+    return m_context;
+}
+
+void QLinuxWebContext::prewarm()
+{
+    webkit_web_context_prewarm(static_cast<WebKitWebContext *>(handle()));
+}
+
+QString QLinuxWebContextOptions::effectiveCookieStoragePath() const
+{
+    if (!persistentCookies)
+        return QString();
+    return cookieStoragePath.isEmpty() ? QLinuxWebContext::defaultCookieStoragePath()
+                                       : cookieStoragePath;
+}
+
+QLinuxWebContextOptions QLinuxWebContextOptions::fromEnvironment()
+{
+    QLinuxWebContextOptions options;
+
+    const QByteArray processModel = qgetenv("QT_WEBVIEW_PROCESS_MODEL");
+    if (processModel == "shared")
+        options.processModel = QLinuxWebContext::SharedSecondaryProcess;
+    else if (processModel == "multiple")
+        options.processModel = QLinuxWebContext::MultipleSecondaryProcesses;
+    else if (!processModel.isEmpty())
+        qWarning() << "Unknown QT_WEBVIEW_PROCESS_MODEL" << processModel;
+
+    bool ok = false;
+    const int limit = qEnvironmentVariableIntValue("QT_WEBVIEW_WEB_PROCESS_LIMIT", &ok);
+    if (ok && limit >= 0)
+        options.webProcessCountLimit = uint(limit);
+
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+    if (!processModel.isEmpty() || qEnvironmentVariableIsSet("QT_WEBVIEW_WEB_PROCESS_LIMIT"))
+        qWarning("QT_WEBVIEW_PROCESS_MODEL and QT_WEBVIEW_WEB_PROCESS_LIMIT are ignored by "
+                 "WebKitGTK 2.26 and later, use QT_WEBVIEW_VIEWS_PER_CONTEXT and "
+                 "QT_WEBVIEW_CACHE_MODEL instead");
+#endif
+
+    const QByteArray cacheModel = qgetenv("QT_WEBVIEW_CACHE_MODEL");
+    if (cacheModel == "document-viewer")
+        options.cacheModel = QLinuxWebContext::DocumentViewerCacheModel;
+    else if (cacheModel == "document-browser")
+        options.cacheModel = QLinuxWebContext::DocumentBrowserCacheModel;
+    else if (cacheModel == "web-browser")
+        options.cacheModel = QLinuxWebContext::WebBrowserCacheModel;
+    else if (!cacheModel.isEmpty())
+        qWarning() << "Unknown QT_WEBVIEW_CACHE_MODEL" << cacheModel;
+
+    const int viewsPerContext = qEnvironmentVariableIntValue("QT_WEBVIEW_VIEWS_PER_CONTEXT", &ok);
+    if (ok && viewsPerContext >= 0)
+        options.viewsPerContext = viewsPerContext;
+
+    options.cookieStoragePath = qEnvironmentVariable("QT_WEBVIEW_COOKIE_STORAGE");
+    options.persistentCookies = !qEnvironmentVariableIsSet("QT_WEBVIEW_COOKIE_STORAGE")
+            || !options.cookieStoragePath.isEmpty();
+    options.prewarm = qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_PREWARM") != 0;
+
+    return options;
+}
+
+QT_END_NAMESPACE
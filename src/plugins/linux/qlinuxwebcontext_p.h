@@ -0,0 +1,141 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXWEBCONTEXT_P_H
+#define QLINUXWEBCONTEXT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qstring.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QLinuxCookieStore;
+class QUrl;
+
+// Returns the device to stream the response from, the backend takes ownership
+// of it. Returning nullptr fails the request. Leaving mimeType empty guesses it
+// from the URL. Handlers run on the GTK thread, see QLinuxGtkThread.
+using QLinuxUrlSchemeHandler = std::function<QIODevice *(const QUrl &url, QByteArray *mimeType)>;
+
+class QLinuxWebContext : public QObject
+{
+    Q_OBJECT
+public:
+    enum ProcessModel {
+        SharedSecondaryProcess,
+        MultipleSecondaryProcesses
+    };
+    Q_ENUM(ProcessModel)
+
+    enum CacheModel {
+        DocumentViewerCacheModel,
+        WebBrowserCacheModel,
+        DocumentBrowserCacheModel
+    };
+    Q_ENUM(CacheModel)
+
+    enum UrlSchemeFlag {
+        SecureScheme = 0x1,
+        CorsEnabledScheme = 0x2,
+        LocalScheme = 0x4
+    };
+    Q_DECLARE_FLAGS(UrlSchemeFlags, UrlSchemeFlag)
+
+    explicit QLinuxWebContext(QObject *parent = nullptr);
+    ~QLinuxWebContext() override;
+
+    // The process model and the process count limit are ignored by WebKitGTK
+    // 2.26 and later, always the case with webkit2gtk-4.1, which use a web
+    // process per view. Memory use is then only tuned by how views are split
+    // across contexts, see viewsPerContext, and by the cache model.
+    ProcessModel processModel() const;
+    void setProcessModel(ProcessModel model);
+    uint webProcessCountLimit() const;
+    void setWebProcessCountLimit(uint limit);
+    CacheModel cacheModel() const;
+    void setCacheModel(CacheModel model);
+
+    // Empty keeps cookies in memory only. A ".txt" file is written in the
+    // Netscape format, anything else is SQLite. Missing directories are created.
+    QString cookieStoragePath() const;
+    void setCookieStoragePath(const QString &path);
+    // cookies.sqlite in the application's data directory, empty if it has none
+    static QString defaultCookieStoragePath();
+    QLinuxCookieStore *cookieStore();
+
+    // Schemes cannot be unregistered from a WebKitWebContext
+    void registerUrlScheme(const QByteArray &scheme, const QLinuxUrlSchemeHandler &handler,
+                           UrlSchemeFlags flags = SecureScheme);
+
+    // WebKitWebsiteDataManager the context is created with, the default one if unset
+    void setWebsiteDataManager(void *manager);
+
+    // WebKitWebContext, created on first use so that the process model
+    // can still be changed before the first web process is spawned.
+    void *handle();
+    // Starts a web process ahead of the first view
+    void prewarm();
+
+    int viewCount() const { return m_viewCount; }
+    void attachView() { ++m_viewCount; }
+    void detachView() { --m_viewCount; }
+
+private:
+    struct UrlScheme
+    {
+        QByteArray scheme;
+        QLinuxUrlSchemeHandler handler;
+        UrlSchemeFlags flags;
+    };
+    void installUrlScheme(const UrlScheme &urlScheme);
+
+    void *m_context = nullptr; // WebKitWebContext
+    void *m_dataManager = nullptr; // WebKitWebsiteDataManager
+    QList<UrlScheme> m_urlSchemes;
+    QLinuxCookieStore *m_cookieStore = nullptr;
+    QString m_cookieStoragePath;
+    ProcessModel m_processModel = MultipleSecondaryProcesses;
+    uint m_webProcessCountLimit = 0;
+    CacheModel m_cacheModel = WebBrowserCacheModel;
+    int m_viewCount = 0;
+};
+
+struct QLinuxWebContextOptions
+{
+    // Both ignored by WebKitGTK 2.26 and later, see QLinuxWebContext::processModel()
+    QLinuxWebContext::ProcessModel processModel = QLinuxWebContext::MultipleSecondaryProcesses;
+    uint webProcessCountLimit = 0; // 0 means no limit
+    QLinuxWebContext::CacheModel cacheModel = QLinuxWebContext::WebBrowserCacheModel;
+    int viewsPerContext = 0; // 0 means all views share a single context
+    // Empty stores cookies in QLinuxWebContext::defaultCookieStoragePath().
+    // An empty QT_WEBVIEW_COOKIE_STORAGE keeps them in memory only.
+    QString cookieStoragePath;
+    bool persistentCookies = true;
+    bool prewarm = false; // prewarm a shared context once the application is idle
+
+    QString effectiveCookieStoragePath() const;
+
+    static QLinuxWebContextOptions fromEnvironment();
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QLinuxWebContext::UrlSchemeFlags)
+
+QT_END_NAMESPACE
+
+#endif // QLINUXWEBCONTEXT_P_H
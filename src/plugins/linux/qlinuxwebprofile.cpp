@@ -0,0 +1,273 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// clang-format off
+#include <webkit2/webkit2.h>
+// clang-format on
+
+#include "qlinuxwebprofile_p.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxwebviewplugin.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qpointer.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct ClearRequest
+{
+    QLinuxWebProfile::ClearCallback callback;
+    QElapsedTimer timer;
+};
+} // namespace
+
+static WebKitWebsiteDataTypes toWebKitDataTypes(QLinuxWebProfile::DataTypes types)
+{
+    if (types == QLinuxWebProfile::AllData)
+        return WEBKIT_WEBSITE_DATA_ALL;
+
+    int result = 0;
+    if (types & QLinuxWebProfile::MemoryCache)
+        result |= WEBKIT_WEBSITE_DATA_MEMORY_CACHE;
+    if (types & QLinuxWebProfile::DiskCache)
+        result |= WEBKIT_WEBSITE_DATA_DISK_CACHE;
+    if (types & QLinuxWebProfile::OfflineApplicationCache)
+        result |= WEBKIT_WEBSITE_DATA_OFFLINE_APPLICATION_CACHE;
+    if (types & QLinuxWebProfile::SessionStorage)
+        result |= WEBKIT_WEBSITE_DATA_SESSION_STORAGE;
+    if (types & QLinuxWebProfile::LocalStorage)
+        result |= WEBKIT_WEBSITE_DATA_LOCAL_STORAGE;
+    if (types & QLinuxWebProfile::IndexedDBDatabases)
+        result |= WEBKIT_WEBSITE_DATA_INDEXEDDB_DATABASES;
+    if (types & QLinuxWebProfile::Cookies)
+        result |= WEBKIT_WEBSITE_DATA_COOKIES;
+    return WebKitWebsiteDataTypes(result);
+}
+
+QLinuxWebProfile::QLinuxWebProfile(QObject *parent) : QObject(parent)
+{
+    m_cacheSizeTimer.setInterval(60000);
+    connect(&m_cacheSizeTimer, &QTimer::timeout, this, &QLinuxWebProfile::checkCacheSize);
+}
+
+QLinuxWebProfile::~QLinuxWebProfile()
+{
+    delete m_context;
+    if (void *dataManager = m_dataManager)
+        QLinuxGtkThread::post([dataManager]() { g_object_unref(dataManager); });
+}
+
+bool QLinuxWebProfile::isCreated(const char *setting) const
+{
+    if (m_context)
+        qWarning() << setting << "cannot be changed once the profile is in use";
+    return m_context != nullptr;
+}
+
+bool QLinuxWebProfile::isOffTheRecord() const
+{
+    return m_offTheRecord;
+}
+
+void QLinuxWebProfile::setOffTheRecord(bool offTheRecord)
+{
+    if (!isCreated("offTheRecord"))
+        m_offTheRecord = offTheRecord;
+}
+
+QString QLinuxWebProfile::persistentStoragePath() const
+{
+    return m_persistentStoragePath;
+}
+
+void QLinuxWebProfile::setPersistentStoragePath(const QString &path)
+{
+    if (!isCreated("persistentStoragePath"))
+        m_persistentStoragePath = path;
+}
+
+QString QLinuxWebProfile::cachePath() const
+{
+    return m_cachePath;
+}
+
+void QLinuxWebProfile::setCachePath(const QString &path)
+{
+    if (!isCreated("cachePath"))
+        m_cachePath = path;
+}
+
+double QLinuxWebProfile::originStorageRatio() const
+{
+    return m_originStorageRatio;
+}
+
+void QLinuxWebProfile::setOriginStorageRatio(double ratio)
+{
+    if (!isCreated("originStorageRatio"))
+        m_originStorageRatio = ratio;
+}
+
+double QLinuxWebProfile::totalStorageRatio() const
+{
+    return m_totalStorageRatio;
+}
+
+void QLinuxWebProfile::setTotalStorageRatio(double ratio)
+{
+    if (!isCreated("totalStorageRatio"))
+        m_totalStorageRatio = ratio;
+}
+
+QLinuxWebContext::CacheModel QLinuxWebProfile::cacheModel() const
+{
+    return m_cacheModel;
+}
+
+void QLinuxWebProfile::setCacheModel(QLinuxWebContext::CacheModel model)
+{
+    m_cacheModel = model;
+    if (m_context)
+        QLinuxGtkThread::invoke([this, model]() { m_context->setCacheModel(model); });
+}
+
+qint64 QLinuxWebProfile::maximumCacheSize() const
+{
+    return m_maximumCacheSize;
+}
+
+void QLinuxWebProfile::setMaximumCacheSize(qint64 bytes)
+{
+    m_maximumCacheSize = bytes;
+    if (m_context && bytes > 0)
+        m_cacheSizeTimer.start();
+    else
+        m_cacheSizeTimer.stop();
+}
+
+int QLinuxWebProfile::cacheSizeCheckInterval() const
+{
+    return m_cacheSizeTimer.interval();
+}
+
+void QLinuxWebProfile::setCacheSizeCheckInterval(int msecs)
+{
+    m_cacheSizeTimer.setInterval(msecs);
+}
+
+void QLinuxWebProfile::clearData(DataTypes types, int timeSpanSecs, const ClearCallback &callback)
+{
+    webContext();
+
+    ClearRequest *request = new ClearRequest{ callback, QElapsedTimer() };
+    request->timer.start();
+    WebKitWebsiteDataManager *dataManager = static_cast<WebKitWebsiteDataManager *>(m_dataManager);
+    QLinuxGtkThread::post([dataManager, types, timeSpanSecs, request]() {
+        webkit_website_data_manager_clear(
+                dataManager, toWebKitDataTypes(types),
+                GTimeSpan(timeSpanSecs) * G_TIME_SPAN_SECOND, nullptr,
+                +[](GObject *object, GAsyncResult *result, gpointer userData) {
+                    ClearRequest *request = static_cast<ClearRequest *>(userData);
+                    GError *error = nullptr;
+                    const bool ok = webkit_website_data_manager_clear_finish(
+                            WEBKIT_WEBSITE_DATA_MANAGER(object), result, &error);
+                    if (!ok) {
+                        qWarning() << "Failed to clear website data:" << error->message;
+                        g_error_free(error);
+                    }
+                    // Callbacks run on the GUI thread
+                    QLinuxGtkThread::deliver(QCoreApplication::instance(), [request, ok]() {
+                        if (request->callback)
+                            request->callback(ok, request->timer.elapsed());
+                        delete request;
+                    });
+                },
+                request);
+    });
+}
+
+QLinuxWebContext *QLinuxWebProfile::webContext()
+{
+    if (m_context)
+        return m_context;
+
+    const QByteArray dataPath = m_offTheRecord ? QByteArray()
+                                               : QFile::encodeName(m_persistentStoragePath);
+    const QByteArray cachePath = m_offTheRecord ? QByteArray() : QFile::encodeName(m_cachePath);
+    QLinuxGtkThread::invoke([this, &dataPath, &cachePath]() {
+        // clang-format off
+        m_dataManager = g_object_new(WEBKIT_TYPE_WEBSITE_DATA_MANAGER,
+                "is-ephemeral", gboolean(m_offTheRecord),
+                "base-data-directory", dataPath.isEmpty() ? nullptr : dataPath.constData(),
+                "base-cache-directory", cachePath.isEmpty() ? nullptr : cachePath.constData(),
+#if WEBKIT_CHECK_VERSION(2, 42, 0)
+                "origin-storage-ratio", m_originStorageRatio,
+                "total-storage-ratio", m_totalStorageRatio,
+#endif
+                nullptr);
+        // clang-format on
+    });
+#if !WEBKIT_CHECK_VERSION(2, 42, 0)
+    if (m_originStorageRatio >= 0 || m_totalStorageRatio >= 0)
+        qWarning("Storage quotas require WebKitGTK 2.42 or later");
+#endif
+
+    m_context = new QLinuxWebContext;
+    QLinuxWebViewPlugin::initializeContext(m_context);
+    m_context->setWebsiteDataManager(m_dataManager);
+    m_context->setCacheModel(m_cacheModel);
+    // WebKit keeps cookies in memory unless told where to store them. Without a
+    // storage path they share the file of the default contexts.
+    QString cookieStoragePath;
+    if (!dataPath.isEmpty())
+        cookieStoragePath = QDir(m_persistentStoragePath).filePath(QStringLiteral("cookies.sqlite"));
+    else if (!m_offTheRecord)
+        cookieStoragePath = QLinuxWebContext::defaultCookieStoragePath();
+    m_context->setCookieStoragePath(cookieStoragePath);
+
+    if (m_maximumCacheSize > 0)
+        m_cacheSizeTimer.start();
+    return m_context;
+}
+
+void QLinuxWebProfile::checkCacheSize()
+{
+    if (!m_dataManager || m_maximumCacheSize <= 0)
+        return;
+
+    QPointer<QLinuxWebProfile> *self = new QPointer<QLinuxWebProfile>(this);
+    WebKitWebsiteDataManager *dataManager = static_cast<WebKitWebsiteDataManager *>(m_dataManager);
+    QLinuxGtkThread::post([dataManager, self]() {
+        webkit_website_data_manager_fetch(
+                dataManager, WEBKIT_WEBSITE_DATA_DISK_CACHE, nullptr,
+                +[](GObject *object, GAsyncResult *result, gpointer userData) {
+                    auto *self = static_cast<QPointer<QLinuxWebProfile> *>(userData);
+                    GList *websites = webkit_website_data_manager_fetch_finish(
+                            WEBKIT_WEBSITE_DATA_MANAGER(object), result, nullptr);
+
+                    guint64 size = 0;
+                    for (GList *it = websites; it; it = it->next) {
+                        WebKitWebsiteData *data = static_cast<WebKitWebsiteData *>(it->data);
+                        size += webkit_website_data_get_size(data,
+                                                             WEBKIT_WEBSITE_DATA_DISK_CACHE);
+                    }
+                    g_list_free_full(websites,
+                                     reinterpret_cast<GDestroyNotify>(webkit_website_data_unref));
+
+                    // There is no way to trim the cache, drop it as a whole
+                    QLinuxGtkThread::deliver(QCoreApplication::instance(), [self, size]() {
+                        if (*self && size > guint64((*self)->m_maximumCacheSize))
+                            (*self)->clearData(DiskCache);
+                        delete self;
+                    });
+                },
+                self);
+    });
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLINUXWEBPROFILE_P_H
+#define QLINUXWEBPROFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qlinuxwebcontext_p.h"
+
+#include <QtCore/qobject.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qtimer.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+// Website data store for the views created with it, backed by its own
+// WebKitWebsiteDataManager and WebKitWebContext. Must outlive those views.
+class QLinuxWebProfile : public QObject
+{
+    Q_OBJECT
+public:
+    enum DataType {
+        MemoryCache = 0x1,
+        DiskCache = 0x2,
+        OfflineApplicationCache = 0x4,
+        SessionStorage = 0x8,
+        LocalStorage = 0x10,
+        IndexedDBDatabases = 0x20,
+        Cookies = 0x40,
+        AllData = 0xff
+    };
+    Q_DECLARE_FLAGS(DataTypes, DataType)
+    Q_FLAG(DataTypes)
+
+    using ClearCallback = std::function<void(bool ok, qint64 elapsedMs)>;
+
+    explicit QLinuxWebProfile(QObject *parent = nullptr);
+    ~QLinuxWebProfile() override;
+
+    // Fixed once the first view has been created with the profile
+    bool isOffTheRecord() const;
+    void setOffTheRecord(bool offTheRecord);
+    QString persistentStoragePath() const;
+    void setPersistentStoragePath(const QString &path);
+    QString cachePath() const;
+    void setCachePath(const QString &path);
+    // Fractions of the volume, negative keeps the WebKit default (2.42 and later)
+    double originStorageRatio() const;
+    void setOriginStorageRatio(double ratio);
+    double totalStorageRatio() const;
+    void setTotalStorageRatio(double ratio);
+
+    QLinuxWebContext::CacheModel cacheModel() const;
+    void setCacheModel(QLinuxWebContext::CacheModel model);
+
+    // WebKit has no size limit for its disk cache. The profile checks the
+    // size periodically and drops the cache once it exceeds the limit.
+    qint64 maximumCacheSize() const;
+    void setMaximumCacheSize(qint64 bytes);
+    int cacheSizeCheckInterval() const;
+    void setCacheSizeCheckInterval(int msecs);
+
+    // Clears the data modified in the last timeSpanSecs seconds, all of it for 0
+    void clearData(DataTypes types, int timeSpanSecs = 0,
+                   const ClearCallback &callback = nullptr);
+
+    QLinuxWebContext *webContext();
+
+private Q_SLOTS:
+    void checkCacheSize();
+
+private:
+    bool isCreated(const char *setting) const;
+
+    void *m_dataManager = nullptr; // WebKitWebsiteDataManager
+    QLinuxWebContext *m_context = nullptr;
+    bool m_offTheRecord = false;
+    QString m_persistentStoragePath;
+    QString m_cachePath;
+    double m_originStorageRatio = -1;
+    double m_totalStorageRatio = -1;
+    QLinuxWebContext::CacheModel m_cacheModel = QLinuxWebContext::WebBrowserCacheModel;
+    qint64 m_maximumCacheSize = 0;
+    QTimer m_cacheSizeTimer;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QLinuxWebProfile::DataTypes)
+
+QT_END_NAMESPACE
+
+#endif // QLINUXWEBPROFILE_P_H
@@ -7,7 +7,14 @@
 // clang-format on
 
 #include "qlinuxwebview_p.h"
+#include "qlinuxwebchanneltransport_p.h"
+#include "qlinuxcookiestore_p.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxpagemetrics_p.h"
+#include "qlinuxwebcontext_p.h"
+#include "qlinuxwebviewplugin.h"
 #include <qwebviewloadrequest_p.h>
+#include <qwebviewtrace_p.h>
 #include <QtWidgets/QtWidgets>
 
 // clang-format off
@@ -64,57 +71,187 @@ void QLinuxWebViewSettingsPrivate::setAllowFileAccess(bool enabled)
     m_allowFileAccess = enabled;
 }
 
-QLinuxWebViewPrivate::QLinuxWebViewPrivate(QObject *parent)
+static QSize defaultOffscreenSize()
+{
+    const QList<QByteArray> size = qgetenv("QT_WEBVIEW_OFFSCREEN_SIZE").split('x');
+    if (size.size() == 2 && size.at(0).toInt() > 0 && size.at(1).toInt() > 0)
+        return QSize(size.at(0).toInt(), size.at(1).toInt());
+    return QSize(1280, 720);
+}
+
+static int resizeSettleTime()
+{
+    bool ok = false;
+    const int msecs = qEnvironmentVariableIntValue("QT_WEBVIEW_RESIZE_SETTLE_TIME", &ok);
+    return ok && msecs > 0 ? msecs : 0;
+}
+
+static int defaultHibernationIdleTime()
+{
+    bool ok = false;
+    const int msecs = qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_HIBERNATE_AFTER", &ok);
+    return ok && msecs > 0 ? msecs : 0;
+}
+
+// Embedded views, only used on the GUI thread
+static QList<QLinuxWebViewPrivate *> &embeddedViews()
+{
+    static QList<QLinuxWebViewPrivate *> views;
+    return views;
+}
+
+static void installLowMemoryHandler()
+{
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    static bool installed = false;
+    if (installed)
+        return;
+    installed = true;
+
+    // The monitor lives as long as the process, its signal is emitted on the GTK thread
+    QLinuxGtkThread::post([]() {
+        g_signal_connect(g_memory_monitor_dup_default(), "low-memory-warning",
+                         G_CALLBACK(+[](GMemoryMonitor *, GMemoryMonitorWarningLevel, gpointer) {
+                             QLinuxGtkThread::deliver(QCoreApplication::instance(), []() {
+                                 QLinuxWebViewPrivate::hibernateBackgroundViews();
+                             });
+                         }),
+                         nullptr);
+    });
+#endif
+}
+
+QLinuxWebViewPrivate::QLinuxWebViewPrivate(QLinuxWebContext *context, QObject *parent)
+    : QLinuxWebViewPrivate(context, EmbeddedMode, parent)
+{
+}
+
+QLinuxWebViewPrivate::QLinuxWebViewPrivate(QLinuxWebContext *context, Mode mode, QObject *parent)
     : QAbstractWebView(parent),
+      m_mode(mode),
+      m_offscreenSize(defaultOffscreenSize()),
+      m_context(context),
       m_settings(new QLinuxWebViewSettingsPrivate(this)),
       m_webview(nullptr),
       m_widget(nullptr),
       m_window(nullptr)
 {
-    // Initialize GTK
-    gtk_init(nullptr, nullptr);
+    m_geometryTimer.setSingleShot(true);
+    m_geometryTimer.setInterval(resizeSettleTime());
+    connect(&m_geometryTimer, &QTimer::timeout, this, &QLinuxWebViewPrivate::updateWindowGeometry);
 
-    // Create WebView
-    m_webview = WEBKIT_WEB_VIEW(webkit_web_view_new());
-    WebKitWebView *webview = (WebKitWebView *)m_webview;
-    if (webview && WEBKIT_IS_WEB_VIEW(webview)) {
-        m_widget = gtk_plug_new(0);
+    // Restarted by every use of the view and when its window is hidden
+    m_hibernationTimer.setSingleShot(true);
+    connect(&m_hibernationTimer, &QTimer::timeout, this, [this]() {
+        if (isInBackground())
+            hibernate();
+    });
+    if (m_mode == EmbeddedMode) {
+        embeddedViews().append(this);
+        setHibernationIdleTime(defaultHibernationIdleTime());
+    }
+
+    // The QObjects stay on this thread, the GTK side is created on the GTK thread
+    QLinuxGtkThread::invoke([this]() {
+        QLinuxGtkThread::initializeGtk();
+
+        if (!createWebKitView())
+            return;
+        WebKitWebView *webview = (WebKitWebView *)m_webview;
+
+        m_widget = m_mode == OffscreenMode ? gtk_offscreen_window_new() : gtk_plug_new(0);
         GtkWidget *widget = (GtkWidget *)m_widget;
-        if (widget) {
-            gtk_container_add(GTK_CONTAINER(widget), GTK_WIDGET(webview));
-            gtk_widget_show_all(widget);
-            gtk_widget_realize(widget);
-            void *hWnd = reinterpret_cast<void *>(gtk_plug_get_id(GTK_PLUG(widget)));
-            if (hWnd) {
-                // Create a QWindow without a parent
-                // This window is used for initializing the WebView2
-                m_window = QWindow::fromWinId(WId(hWnd));
-                m_window->setFlag(Qt::FramelessWindowHint); // No border
-                QTimer::singleShot(0, this, [this, hWnd]() { emit initialize(hWnd); });
-            } else {
-                qWarning() << "Can not get plug widget handle";
-            }
-        } else {
+        if (!widget) {
             qWarning() << "Failed to create plug widget";
+            return;
         }
-    } else {
-        qWarning() << "Failed to create WebKit view";
+
+        if (m_mode == OffscreenMode) {
+            // Accelerated layers would be composited in the UI process, out of reach of
+            // the offscreen window, so paint through the backing store instead.
+            webkit_settings_set_hardware_acceleration_policy(
+                    webkit_web_view_get_settings(webview),
+                    WEBKIT_HARDWARE_ACCELERATION_POLICY_NEVER);
+            gtk_widget_set_size_request(GTK_WIDGET(webview), m_offscreenSize.width(),
+                                        m_offscreenSize.height());
+        }
+        gtk_container_add(GTK_CONTAINER(widget), GTK_WIDGET(webview));
+        gtk_widget_show_all(widget);
+        gtk_widget_realize(widget);
+        if (m_mode == EmbeddedMode) {
+            m_plugId = WId(gtk_plug_get_id(GTK_PLUG(widget)));
+            if (!m_plugId)
+                qWarning() << "Can not get plug widget handle";
+        }
+
+        // Remember the blank state, reset() goes back to it when the view is pooled
+        m_pristineSessionState = webkit_web_view_get_session_state(webview);
+        m_defaultUserAgent = QString::fromUtf8(
+                webkit_settings_get_user_agent(webkit_web_view_get_settings(webview)));
+        m_httpUserAgent = m_defaultUserAgent;
+    });
+
+    if (m_mode == OffscreenMode && m_widget) {
+        QTimer::singleShot(0, this, [this]() { emit initialize(nullptr); });
+    } else if (m_plugId) {
+        createNativeWindow();
+        void *hWnd = reinterpret_cast<void *>(m_plugId);
+        QTimer::singleShot(0, this, [this, hWnd]() { emit initialize(hWnd); });
     }
 };
 
+bool QLinuxWebViewPrivate::createWebKitView()
+{
+    // Create WebView in the shared context
+    m_webview = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(
+            static_cast<WebKitWebContext *>(m_context->handle())));
+    WebKitWebView *webview = (WebKitWebView *)m_webview;
+    if (!webview || !WEBKIT_IS_WEB_VIEW(webview)) {
+        qWarning() << "Failed to create WebKit view";
+        return false;
+    }
+    return true;
+}
+
+void QLinuxWebViewPrivate::createNativeWindow()
+{
+    // Create a QWindow without a parent
+    // This window is used for embedding the GtkPlug
+    m_window = QWindow::fromWinId(m_plugId);
+    m_window->setFlag(Qt::FramelessWindowHint); // No border
+
+    connect(m_window, &QWindow::widthChanged, this,
+            &QLinuxWebViewPrivate::scheduleWindowGeometryUpdate);
+    connect(m_window, &QWindow::heightChanged, this,
+            &QLinuxWebViewPrivate::scheduleWindowGeometryUpdate);
+    connect(m_window, &QWindow::screenChanged, this,
+            &QLinuxWebViewPrivate::scheduleWindowGeometryUpdate);
+    connect(m_window, &QWindow::visibleChanged, this, [this](bool visible) {
+        if (visible) {
+            m_shown = true;
+            leavePool();
+        } else if (hibernationIdleTime() > 0 && isInBackground()) {
+            m_hibernationTimer.start();
+        }
+    });
+}
+
 void QLinuxWebViewPrivate::initialize(void *hWnd)
 {
-    connect(m_window, &QWindow::widthChanged, this, &QLinuxWebViewPrivate::updateWindowGeometry,
-            Qt::QueuedConnection);
-    connect(m_window, &QWindow::heightChanged, this, &QLinuxWebViewPrivate::updateWindowGeometry,
-            Qt::QueuedConnection);
-    connect(m_window, &QWindow::screenChanged, this, &QLinuxWebViewPrivate::updateWindowGeometry,
-            Qt::QueuedConnection);
+    QLinuxGtkThread::post([this]() { connectCallbacks(); });
+}
 
+void QLinuxWebViewPrivate::connectCallbacks()
+{
     g_signal_connect_swapped(m_widget, "destroy", G_CALLBACK(+[](QLinuxWebViewPrivate *instance) {
                                  qDebug() << "webview container destroy";
                              }),
                              this);
+    connectWebViewCallbacks();
+}
+
+void QLinuxWebViewPrivate::connectWebViewCallbacks()
+{
     g_signal_connect_swapped(m_webview, "destroy", G_CALLBACK(+[](QLinuxWebViewPrivate *instance) {
                                  qDebug() << "webview destroy";
                              }),
@@ -141,6 +278,13 @@ void QLinuxWebViewPrivate::initialize(void *hWnd)
                              }),
                              this);
 
+    // loading state
+    g_signal_connect_swapped(m_webview, "notify::is-loading",
+                             G_CALLBACK(+[](QLinuxWebViewPrivate *instance, GParamSpec *pspec) {
+                                 instance->loadingStateCallback();
+                             }),
+                             this);
+
     // load status
     g_signal_connect_swapped(m_webview, "load-changed",
                              G_CALLBACK(+[](QLinuxWebViewPrivate *instance, WebKitLoadEvent event) {
@@ -156,161 +300,929 @@ void QLinuxWebViewPrivate::initialize(void *hWnd)
                                  return false;
                              }),
                              this);
+
+    // history change, for canGoBack() and canGoForward()
+    g_signal_connect_swapped(webkit_web_view_get_back_forward_list(
+                                     static_cast<WebKitWebView *>(m_webview)),
+                             "changed",
+                             G_CALLBACK(+[](QLinuxWebViewPrivate *instance) {
+                                 instance->historyChangedCallback();
+                             }),
+                             this);
 }
 
 QLinuxWebViewPrivate::~QLinuxWebViewPrivate()
 {
-    stop();
+    embeddedViews().removeOne(this);
 
-    if (m_widget) {
-        GtkWidget *widget = (GtkWidget *)m_widget;
-        gtk_widget_hide(widget);
-        gtk_widget_destroy(widget);
-        m_widget = nullptr;
-    }
+    // Unregister their script message handlers, must go before the view
+    delete m_webChannelTransport;
+    delete m_pageMetricsObserver;
+
+    // Runs after everything posted before, and no callback reaches this object afterwards
+    QLinuxGtkThread::invoke([this]() {
+        if (m_webview) {
+            WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+            webkit_web_view_stop_loading(webview);
+            g_signal_handlers_disconnect_by_data(webkit_web_view_get_back_forward_list(webview),
+                                                 this);
+            g_signal_handlers_disconnect_by_data(webview, this);
+        }
+
+        if (m_widget) {
+            GtkWidget *widget = (GtkWidget *)m_widget;
+            g_signal_handlers_disconnect_by_data(widget, this);
+            gtk_widget_hide(widget);
+            gtk_widget_destroy(widget);
+            m_widget = nullptr;
+        }
+
+        if (m_pristineSessionState)
+            webkit_web_view_session_state_unref(
+                    static_cast<WebKitWebViewSessionState *>(m_pristineSessionState));
+    });
 
     if (m_window) {
         m_window->destroy();
     }
+
+    QLinuxWebViewPlugin::releaseContext(m_context);
 }
 
-QString QLinuxWebViewPrivate::httpUserAgent() const
+bool QLinuxWebViewPrivate::reset()
 {
-    if (m_webview) {
-        WebKitSettings *settings =
-                webkit_web_view_get_settings(static_cast<WebKitWebView *>(m_webview));
-        if (settings) {
-            return webkit_settings_get_user_agent(settings);
-        }
+    wake();
+    if (!m_webview || !m_widget || !m_pristineSessionState)
+        return false;
+    // Views of a profile keep its data, they must not be handed out as default views
+    if (!QLinuxWebViewPlugin::contexts().contains(m_context))
+        return false;
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    WebKitWebViewSessionState *pristineSessionState =
+            static_cast<WebKitWebViewSessionState *>(m_pristineSessionState);
+    delete m_webChannelTransport;
+    m_webChannelTransport = nullptr;
+    setPageMetricsEnabled(false);
+
+    QLinuxGtkThread::post([this, webview, pristineSessionState]() {
+        webkit_web_view_stop_loading(webview);
+        // Drop the back/forward history of the previous owner
+        webkit_web_view_restore_session_state(webview, pristineSessionState);
+        // Set first, the URI changes within the call
+        m_resetLoadPending = true;
+        webkit_web_view_load_uri(webview, "about:blank");
+    });
+
+    setHttpUserAgent(m_defaultUserAgent);
+    m_settings->setJavaScriptEnabled(true);
+    m_settings->setAllowFileAccess(false);
+    m_url.clear();
+    m_title.clear();
+    m_loadProgress = 0;
+    m_canGoBack = false;
+    m_canGoForward = false;
+
+    // Take the window back from its container, a container deletes the window
+    // it owns, in that case nativeWindow() creates a new one for the next owner.
+    if (m_window) {
+        m_window->hide();
+        m_window->setParent(nullptr);
+    }
+    // A pooled view has to be ready, not hibernated. Set last, the calls above
+    // count as uses of the view.
+    m_hibernationTimer.stop();
+    m_pooled = true;
+
+    return true;
+}
+
+QWebChannelAbstractTransport *QLinuxWebViewPrivate::webChannelTransport()
+{
+    touch();
+    if (!m_webChannelTransport && m_webview)
+        m_webChannelTransport = new QLinuxWebChannelTransport(m_webview, this);
+    return m_webChannelTransport;
+}
+
+bool QLinuxWebViewPrivate::setPageMetricsEnabled(bool enabled)
+{
+    if (!enabled) {
+        delete m_pageMetricsObserver;
+        m_pageMetricsObserver = nullptr;
+        return true;
+    }
+    touch();
+    if (!m_webview)
+        return false;
+
+    if (!m_pageMetricsObserver) {
+        // The blank page of reset() is not reported
+        m_pageMetricsObserver = new QLinuxPageMetricsObserver(
+                m_webview,
+                [this]() -> quint64 { return m_navigation.reset ? 0 : m_navigation.id; }, this);
+        connect(m_pageMetricsObserver, &QLinuxPageMetricsObserver::metricsReceived, this,
+                [this](const QWebViewPageMetrics &metrics) {
+                    if (metrics.navigationId != 0)
+                        emit pageMetricsReceived(metrics);
+                });
     }
+    return true;
+}
 
-    return "";
+QString QLinuxWebViewPrivate::httpUserAgent() const
+{
+    return m_httpUserAgent;
 }
 
 void QLinuxWebViewPrivate::setHttpUserAgent(const QString &userAgent)
 {
-    if (m_webview) {
-        WebKitSettings *settings =
-                webkit_web_view_get_settings(static_cast<WebKitWebView *>(m_webview));
-        if (settings) {
-            return webkit_settings_set_user_agent(settings, userAgent.toUtf8().constData());
-        }
-    }
+    touch();
+    if (!m_webview)
+        return;
+
+    // WebKit falls back to its default for an empty user agent
+    m_httpUserAgent = userAgent.isEmpty() ? m_defaultUserAgent : userAgent;
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    const QByteArray agent = userAgent.toUtf8();
+    QLinuxGtkThread::post([webview, agent]() {
+        webkit_settings_set_user_agent(webkit_web_view_get_settings(webview), agent.constData());
+    });
 }
 
 void QLinuxWebViewPrivate::setUrl(const QUrl &url)
 {
+    touch();
     m_url = url;
     if (m_webview && url.isValid()) {
-        webkit_web_view_load_uri((WebKitWebView *)m_webview, url.toString().toUtf8().constData());
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        const QByteArray uri = url.toString().toUtf8();
+        QLinuxGtkThread::post(
+                [webview, uri]() { webkit_web_view_load_uri(webview, uri.constData()); });
     }
 }
 
 bool QLinuxWebViewPrivate::canGoBack() const
 {
-    if (m_webview) {
-        return webkit_web_view_can_go_back(static_cast<WebKitWebView *>(m_webview));
-    }
-
-    return false;
+    return m_canGoBack;
 }
 
 bool QLinuxWebViewPrivate::canGoForward() const
 {
-    if (m_webview) {
-        return webkit_web_view_can_go_forward(static_cast<WebKitWebView *>(m_webview));
-    }
-
-    return false;
+    return m_canGoForward;
 }
 
 QString QLinuxWebViewPrivate::title() const
 {
-    if (m_webview) {
-        return webkit_web_view_get_title(static_cast<WebKitWebView *>(m_webview));
-    }
-
-    return "";
+    return m_title;
 }
 
 int QLinuxWebViewPrivate::loadProgress() const
 {
-    if (!m_webview) {
-        return 0;
-    }
-
-    return webkit_web_view_get_estimated_load_progress(static_cast<WebKitWebView *>(m_webview))
-            * 100;
+    return m_loadProgress;
 }
 
 bool QLinuxWebViewPrivate::isLoading() const
 {
-    if (m_webview) {
-        return webkit_web_view_is_loading(static_cast<WebKitWebView *>(m_webview));
-    }
-    return false;
+    return m_loading;
 }
 
 QWindow *QLinuxWebViewPrivate::nativeWindow() const
 {
+    if (!m_window && m_widget && m_mode == EmbeddedMode)
+        const_cast<QLinuxWebViewPrivate *>(this)->createNativeWindow();
     return m_window;
 }
 
 void QLinuxWebViewPrivate::goBack()
 {
+    touch();
     if (m_webview) {
-        webkit_web_view_go_back(static_cast<WebKitWebView *>(m_webview));
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        QLinuxGtkThread::post([webview]() { webkit_web_view_go_back(webview); });
     }
 }
 
 void QLinuxWebViewPrivate::goForward()
 {
+    touch();
     if (m_webview) {
-        webkit_web_view_go_forward(static_cast<WebKitWebView *>(m_webview));
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        QLinuxGtkThread::post([webview]() { webkit_web_view_go_forward(webview); });
     }
 }
 
 void QLinuxWebViewPrivate::reload()
 {
+    touch();
     if (m_webview) {
-        webkit_web_view_reload(static_cast<WebKitWebView *>(m_webview));
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        QLinuxGtkThread::post([webview]() { webkit_web_view_reload(webview); });
     }
 }
 
 void QLinuxWebViewPrivate::stop()
 {
     if (m_webview) {
-        webkit_web_view_stop_loading(static_cast<WebKitWebView *>(m_webview));
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        QLinuxGtkThread::post([webview]() { webkit_web_view_stop_loading(webview); });
     }
 }
 
 void QLinuxWebViewPrivate::loadHtml(const QString &html, const QUrl &baseUrl)
 {
+    touch();
     if (m_webview) {
-        webkit_web_view_load_html((WebKitWebView *)m_webview, html.toUtf8().constData(),
-                                  baseUrl.toString().toUtf8().constData());
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        const QByteArray content = html.toUtf8();
+        const QByteArray base = baseUrl.toString().toUtf8();
+        QLinuxGtkThread::post([webview, content, base]() {
+            webkit_web_view_load_html(webview, content.constData(), base.constData());
+        });
     }
 }
 
+void QLinuxWebViewPrivate::loadData(const QByteArray &data, const QString &mimeType,
+                                    const QString &encoding, const QUrl &baseUrl)
+{
+    touch();
+    if (!m_webview)
+        return;
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    const QByteArray mime = mimeType.toUtf8();
+    const QByteArray charset = encoding.toUtf8();
+    const QByteArray base = baseUrl.toString().toUtf8();
+    QLinuxGtkThread::post([webview, data, mime, charset, base]() {
+        // GBytes borrows the array's storage, the heap copy only holds a reference
+        // so the data stays alive for as long as WebKit needs it.
+        QByteArray *storage = new QByteArray(data);
+        GBytes *bytes = g_bytes_new_with_free_func(
+                storage->constData(), gsize(storage->size()),
+                [](gpointer storage) { delete static_cast<QByteArray *>(storage); }, storage);
+
+        webkit_web_view_load_bytes(webview, bytes, mime.isEmpty() ? nullptr : mime.constData(),
+                                   charset.isEmpty() ? nullptr : charset.constData(),
+                                   base.constData());
+        g_bytes_unref(bytes);
+    });
+}
+
+// Results of asynchronous calls arrive on the GTK thread, the view may be gone
+// by the time they have been handed over to the GUI thread.
+template<typename Function>
+static void deliverToView(const QPointer<QLinuxWebViewPrivate> &view, Function function)
+{
+    QLinuxGtkThread::deliver(QCoreApplication::instance(), [view, function]() {
+        if (view)
+            function(view.data());
+    });
+}
+
 void QLinuxWebViewPrivate::setCookie(const QString &domain, const QString &name,
                                      const QString &value)
 {
+    QLinuxCookie cookie;
+    cookie.domain = domain;
+    cookie.name = name;
+    cookie.value = value;
+
+    QPointer<QLinuxWebViewPrivate> self(this);
+    QLinuxCookieStore *cookieStore = m_context->cookieStore();
+    QLinuxGtkThread::post([self, cookieStore, cookie]() {
+        cookieStore->addCookies({ cookie }, [self](const QList<QLinuxCookie> &cookies) {
+            deliverToView(self, [cookies](QLinuxWebViewPrivate *view) {
+                for (const QLinuxCookie &cookie : cookies)
+                    emit view->cookieAdded(cookie.domain, cookie.name);
+            });
+        });
+    });
+}
+
+void QLinuxWebViewPrivate::deleteCookie(const QString &domainName, const QString &cookieName)
+{
+    QLinuxCookie cookie;
+    cookie.domain = domainName;
+    cookie.name = cookieName;
+
+    QPointer<QLinuxWebViewPrivate> self(this);
+    QLinuxCookieStore *cookieStore = m_context->cookieStore();
+    QLinuxGtkThread::post([self, cookieStore, cookie]() {
+        cookieStore->deleteCookies({ cookie }, [self, cookie](const QList<QLinuxCookie> &cookies) {
+            if (cookies.isEmpty())
+                return;
+            deliverToView(self, [cookie](QLinuxWebViewPrivate *view) {
+                emit view->cookieRemoved(cookie.domain, cookie.name);
+            });
+        });
+    });
+}
+
+void QLinuxWebViewPrivate::deleteAllCookies()
+{
+    QPointer<QLinuxWebViewPrivate> self(this);
+    QLinuxCookieStore *cookieStore = m_context->cookieStore();
+    QLinuxGtkThread::post([self, cookieStore]() {
+        cookieStore->deleteAllCookies([self](const QList<QLinuxCookie> &cookies) {
+            deliverToView(self, [cookies](QLinuxWebViewPrivate *view) {
+                for (const QLinuxCookie &cookie : cookies)
+                    emit view->cookieRemoved(cookie.domain, cookie.name);
+            });
+        });
+    });
+}
+
+void QLinuxWebViewPrivate::setOffscreenSize(const QSize &size)
+{
+    if (m_mode != OffscreenMode || size.isEmpty())
+        return;
+
+    m_offscreenSize = size;
+    if (m_webview) {
+        GtkWidget *webview = GTK_WIDGET(m_webview);
+        GtkWindow *window = GTK_WINDOW(m_widget);
+        QLinuxGtkThread::post([webview, window, size]() {
+            gtk_widget_set_size_request(webview, size.width(), size.height());
+            gtk_window_resize(window, size.width(), size.height());
+        });
+    }
 }
 
-void QLinuxWebViewPrivate::deleteCookie(const QString &domainName, const QString &cookieName) { }
+QImage QLinuxWebViewPrivate::renderFrame() const
+{
+    if (m_mode != OffscreenMode || !m_webview)
+        return QImage();
 
-void QLinuxWebViewPrivate::deleteAllCookies() { }
+    // Cairo paints straight into the image, both use premultiplied native-endian ARGB
+    QImage frame(m_offscreenSize, QImage::Format_ARGB32_Premultiplied);
+    frame.fill(Qt::transparent);
+    GtkWidget *webview = GTK_WIDGET(m_webview);
+    QLinuxGtkThread::invoke([webview, &frame]() {
+        cairo_surface_t *surface = cairo_image_surface_create_for_data(
+                frame.bits(), CAIRO_FORMAT_ARGB32, frame.width(), frame.height(),
+                frame.bytesPerLine());
+        cairo_t *cr = cairo_create(surface);
+        gtk_widget_draw(webview, cr);
+        cairo_destroy(cr);
+        cairo_surface_destroy(surface);
+    });
+    return frame;
+}
+
+void QLinuxWebViewPrivate::scheduleWindowGeometryUpdate()
+{
+    // A resize changes width and height one after the other, and every size
+    // request makes WebKit lay the page out again. With a settle time each
+    // change pushes the update back, so only the final size is laid out.
+    if (m_geometryTimer.interval() > 0 || !m_geometryTimer.isActive())
+        m_geometryTimer.start();
+}
 
 void QLinuxWebViewPrivate::updateWindowGeometry()
 {
-    if (m_widget) {
-        gtk_widget_set_size_request((GtkWidget *)m_widget,
-                                    m_window->width() * m_window->devicePixelRatio(),
-                                    m_window->height() * m_window->devicePixelRatio());
+    if (m_widget && m_window) {
+        const QSize size = m_window->size() * m_window->devicePixelRatio();
+        if (size == m_appliedSize)
+            return;
+        m_appliedSize = size;
+
+        GtkWidget *widget = (GtkWidget *)m_widget;
+        QLinuxGtkThread::post([widget, size]() {
+            gtk_widget_set_size_request(widget, size.width(), size.height());
+        });
     }
 }
 
-void QLinuxWebViewPrivate::runJavaScriptPrivate(const QString &script, int callbackId) { }
+namespace {
+// Converts the result in place instead of serializing it to JSON and parsing it
+// back, which is what the other backends have to do.
+//
+// Like JSON.stringify, a value that contains itself fails. JavaScriptCore hands
+// out one JSCValue per object, so objects are told apart by pointer. An object
+// that is reached again on another path, without a cycle, is converted once.
+class JSCValueConverter
+{
+public:
+    ~JSCValueConverter()
+    {
+        for (auto it = m_converted.cbegin(); it != m_converted.cend(); ++it)
+            g_object_unref(it.key());
+    }
+
+    QVariant convert(JSCValue *value);
+    // Set once the conversion failed, the result is null then
+    QString errorString() const { return m_errorString; }
+
+private:
+    QVariant convertObject(JSCValue *value);
+    QVariant fail(const QString &errorString)
+    {
+        if (m_errorString.isEmpty())
+            m_errorString = errorString;
+        return QVariant();
+    }
+
+    // Deeper values fail instead of exhausting the stack of the thread
+    static constexpr int maximumDepth = 512;
+
+    QVector<JSCValue *> m_path; // objects being converted, the innermost last
+    QHash<JSCValue *, QVariant> m_converted; // holds a reference to each key
+    QString m_errorString;
+};
+} // namespace
+
+QVariant JSCValueConverter::convert(JSCValue *value)
+{
+    if (!value || !m_errorString.isEmpty() || jsc_value_is_undefined(value)
+        || jsc_value_is_null(value)) {
+        return QVariant();
+    }
+
+    if (jsc_value_is_boolean(value))
+        return QVariant(bool(jsc_value_to_boolean(value)));
+
+    if (jsc_value_is_number(value)) {
+        const double number = jsc_value_to_double(value);
+        // Casting NaN, infinities or numbers beyond the range of qint64 is undefined
+        if (qIsFinite(number) && qAbs(number) <= double(Q_INT64_C(1) << 53)) {
+            const qint64 integer = qint64(number);
+            if (double(integer) == number)
+                return QVariant(integer);
+        }
+        return QVariant(number);
+    }
+
+    if (jsc_value_is_string(value)) {
+        gchar *string = jsc_value_to_string(value);
+        const QString result = QString::fromUtf8(string);
+        g_free(string);
+        return result;
+    }
+
+    if (jsc_value_is_object(value) && !jsc_value_is_function(value)) {
+        const auto converted = m_converted.constFind(value);
+        if (converted != m_converted.constEnd())
+            return converted.value();
+        if (m_path.contains(value))
+            return fail(QStringLiteral("TypeError: cannot convert a cyclic structure"));
+        if (m_path.size() >= maximumDepth)
+            return fail(QStringLiteral("RangeError: value nested too deeply"));
+
+        m_path.append(value);
+        const QVariant result = convertObject(value);
+        m_path.removeLast();
+        m_converted.insert(JSC_VALUE(g_object_ref(value)), result);
+        return result;
+    }
+
+    return QVariant();
+}
+
+QVariant JSCValueConverter::convertObject(JSCValue *value)
+{
+    if (jsc_value_is_array(value)) {
+        JSCValue *lengthValue = jsc_value_object_get_property(value, "length");
+        const int length = jsc_value_to_int32(lengthValue);
+        g_object_unref(lengthValue);
+
+        QVariantList list;
+        list.reserve(length);
+        for (int i = 0; i < length && m_errorString.isEmpty(); ++i) {
+            JSCValue *item = jsc_value_object_get_property_at_index(value, guint(i));
+            list.append(convert(item));
+            g_object_unref(item);
+        }
+        return list;
+    }
+
+    QVariantMap map;
+    gchar **names = jsc_value_object_enumerate_properties(value);
+    for (gchar **name = names; name && *name && m_errorString.isEmpty(); ++name) {
+        JSCValue *property = jsc_value_object_get_property(value, *name);
+        map.insert(QString::fromUtf8(*name), convert(property));
+        g_object_unref(property);
+    }
+    g_strfreev(names);
+    return map;
+}
+
+namespace {
+struct JavaScriptCallback
+{
+    QPointer<QLinuxWebViewPrivate> view;
+    int callbackId;
+};
+} // namespace
+
+static void javaScriptFinished(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    Q_WEBVIEW_TRACE_SPAN("QLinuxWebViewPrivate::javaScriptFinished");
+    QScopedPointer<JavaScriptCallback> callback(static_cast<JavaScriptCallback *>(userData));
+    GError *error = nullptr;
+
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    JSCValue *value =
+            webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(object), result, &error);
+#else
+    JSCValue *value = nullptr;
+    WebKitJavascriptResult *jsResult =
+            webkit_web_view_run_javascript_finish(WEBKIT_WEB_VIEW(object), result, &error);
+    if (jsResult) {
+        value = JSC_VALUE(g_object_ref(webkit_javascript_result_get_js_value(jsResult)));
+        webkit_javascript_result_unref(jsResult);
+    }
+#endif
+
+    const int callbackId = callback->callbackId;
+    QVariant resultValue;
+    if (error) {
+        resultValue = QString::fromUtf8(error->message);
+    } else {
+        JSCValueConverter converter;
+        resultValue = converter.convert(value);
+        if (!converter.errorString().isEmpty())
+            resultValue = converter.errorString();
+    }
+    deliverToView(callback->view, [callbackId, resultValue](QLinuxWebViewPrivate *view) {
+        emit view->javaScriptResult(callbackId, resultValue);
+    });
+
+    if (value)
+        g_object_unref(value);
+    if (error)
+        g_error_free(error);
+}
+
+void QLinuxWebViewPrivate::runJavaScriptPrivate(const QString &script, int callbackId)
+{
+    touch();
+    if (!m_webview)
+        return;
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    const QByteArray source = script.toUtf8();
+
+    // A callback id of -1 means nobody is waiting for the result
+    GAsyncReadyCallback finished = nullptr;
+    JavaScriptCallback *callback = nullptr;
+    if (callbackId != -1) {
+        finished = javaScriptFinished;
+        callback = new JavaScriptCallback{ this, callbackId };
+    }
+
+    QLinuxGtkThread::post([webview, source, finished, callback]() {
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+        webkit_web_view_evaluate_javascript(webview, source.constData(), source.size(), nullptr,
+                                            nullptr, nullptr, finished, callback);
+#else
+        webkit_web_view_run_javascript(webview, source.constData(), nullptr, finished, callback);
+#endif
+    });
+}
+
+namespace {
+struct SnapshotCallback
+{
+    QPointer<QLinuxWebViewPrivate> view;
+    int callbackId;
+    QSize targetSize;
+};
+} // namespace
+
+// Wraps the pixels of an image surface, the image keeps a reference to the
+// surface until it is destroyed. Other surface types are painted into an image.
+static QImage imageFromSurface(cairo_surface_t *surface)
+{
+    if (cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        double x1, y1, x2, y2;
+        cairo_t *cr = cairo_create(surface);
+        cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+        cairo_destroy(cr);
+
+        cairo_surface_t *image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, int(x2 - x1),
+                                                            int(y2 - y1));
+        cr = cairo_create(image);
+        cairo_set_source_surface(cr, surface, -x1, -y1);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        const QImage result = imageFromSurface(image);
+        cairo_surface_destroy(image);
+        return result;
+    }
+
+    QImage::Format format;
+    switch (cairo_image_surface_get_format(surface)) {
+    case CAIRO_FORMAT_ARGB32:
+        format = QImage::Format_ARGB32_Premultiplied;
+        break;
+    case CAIRO_FORMAT_RGB24:
+        format = QImage::Format_RGB32;
+        break;
+    default:
+        qWarning() << "Unsupported snapshot format" << cairo_image_surface_get_format(surface);
+        return QImage();
+    }
+
+    cairo_surface_flush(surface);
+    QImageCleanupFunction release = [](void *surface) {
+        cairo_surface_destroy(static_cast<cairo_surface_t *>(surface));
+    };
+    return QImage(cairo_image_surface_get_data(surface), cairo_image_surface_get_width(surface),
+                  cairo_image_surface_get_height(surface),
+                  cairo_image_surface_get_stride(surface), format, release,
+                  cairo_surface_reference(surface));
+}
+
+static void snapshotFinished(GObject *object, GAsyncResult *result, gpointer userData)
+{
+    Q_WEBVIEW_TRACE_SPAN("QLinuxWebViewPrivate::snapshotFinished");
+    QScopedPointer<SnapshotCallback> callback(static_cast<SnapshotCallback *>(userData));
+    GError *error = nullptr;
+    cairo_surface_t *surface =
+            webkit_web_view_get_snapshot_finish(WEBKIT_WEB_VIEW(object), result, &error);
+
+    QImage image;
+    if (surface) {
+        image = imageFromSurface(surface);
+        cairo_surface_destroy(surface);
+    } else {
+        qWarning() << "Snapshot failed:" << error->message;
+        g_error_free(error);
+    }
+
+    // Only thumbnails pay for a copy
+    const QSize &targetSize = callback->targetSize;
+    if (!image.isNull() && targetSize.isValid()
+        && (image.width() > targetSize.width() || image.height() > targetSize.height()))
+        image = image.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    const int callbackId = callback->callbackId;
+    deliverToView(callback->view, [callbackId, image](QLinuxWebViewPrivate *view) {
+        emit view->snapshotReady(callbackId, image);
+    });
+}
+
+void QLinuxWebViewPrivate::grabSnapshot(SnapshotRegion region, const QSize &targetSize,
+                                        int callbackId)
+{
+    // Answered from the hibernation snapshot, without waking the view up
+    if (m_hibernation == Hibernated) {
+        QImage image = m_hibernationSnapshot;
+        if (!image.isNull() && targetSize.isValid()
+            && (image.width() > targetSize.width() || image.height() > targetSize.height()))
+            image = image.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QMetaObject::invokeMethod(
+                this, [this, callbackId, image]() { emit snapshotReady(callbackId, image); },
+                Qt::QueuedConnection);
+        return;
+    }
+
+    if (!m_webview) {
+        QAbstractWebView::grabSnapshot(region, targetSize, callbackId);
+        return;
+    }
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    const WebKitSnapshotRegion snapshotRegion = region == FullDocumentSnapshotRegion
+            ? WEBKIT_SNAPSHOT_REGION_FULL_DOCUMENT
+            : WEBKIT_SNAPSHOT_REGION_VISIBLE;
+    SnapshotCallback *callback = new SnapshotCallback{ this, callbackId, targetSize };
+    QLinuxGtkThread::post([webview, snapshotRegion, callback]() {
+        webkit_web_view_get_snapshot(webview, snapshotRegion, WEBKIT_SNAPSHOT_OPTIONS_NONE,
+                                     nullptr, snapshotFinished, callback);
+    });
+}
+
+namespace {
+struct HibernationCallback
+{
+    QPointer<QLinuxWebViewPrivate> view;
+};
+} // namespace
+
+// The surface borrows the pixels, and keeps a copy of the image alive for them
+static cairo_surface_t *surfaceFromImage(const QImage &image)
+{
+    QImage *pixels = new QImage(image.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    cairo_surface_t *surface = cairo_image_surface_create_for_data(
+            const_cast<uchar *>(pixels->constBits()), CAIRO_FORMAT_ARGB32, pixels->width(),
+            pixels->height(), pixels->bytesPerLine());
+    static cairo_user_data_key_t pixelsKey;
+    cairo_surface_set_user_data(surface, &pixelsKey, pixels,
+                                [](void *pixels) { delete static_cast<QImage *>(pixels); });
+    return surface;
+}
+
+static QByteArray serializeSessionState(WebKitWebView *webview)
+{
+    WebKitWebViewSessionState *state = webkit_web_view_get_session_state(webview);
+    GBytes *bytes = webkit_web_view_session_state_serialize(state);
+    gsize size = 0;
+    const char *data = static_cast<const char *>(g_bytes_get_data(bytes, &size));
+    const QByteArray serialized(data, int(size));
+    g_bytes_unref(bytes);
+    webkit_web_view_session_state_unref(state);
+    return serialized;
+}
+
+// Brings back the back/forward list, then loads its current item again.
+// Returns false if the state is invalid or has no current item.
+static bool restoreSessionState(WebKitWebView *webview, const QByteArray &serialized)
+{
+    GBytes *bytes = g_bytes_new(serialized.constData(), gsize(serialized.size()));
+    WebKitWebViewSessionState *state = webkit_web_view_session_state_new(bytes);
+    g_bytes_unref(bytes);
+    if (!state)
+        return false;
+    webkit_web_view_restore_session_state(webview, state);
+    webkit_web_view_session_state_unref(state);
+
+    WebKitBackForwardListItem *item = webkit_back_forward_list_get_current_item(
+            webkit_web_view_get_back_forward_list(webview));
+    if (!item)
+        return false;
+    webkit_web_view_go_to_back_forward_list_item(webview, item);
+    return true;
+}
+
+void QLinuxWebViewPrivate::setHibernationIdleTime(int msecs)
+{
+    m_hibernationTimer.setInterval(qMax(0, msecs));
+    if (msecs > 0) {
+        installLowMemoryHandler();
+        if (isInBackground())
+            m_hibernationTimer.start();
+    } else {
+        m_hibernationTimer.stop();
+    }
+}
+
+void QLinuxWebViewPrivate::leavePool()
+{
+    if (!m_pooled)
+        return;
+    m_pooled = false;
+    // Runs before the new owner's first load, which must not be hidden
+    QLinuxGtkThread::post([this]() { m_resetLoadPending = false; });
+}
+
+void QLinuxWebViewPrivate::touch()
+{
+    leavePool();
+    wake();
+    if (hibernationIdleTime() > 0 && isInBackground())
+        m_hibernationTimer.start();
+}
+
+bool QLinuxWebViewPrivate::hibernate()
+{
+    if (m_hibernation != Awake || m_mode != EmbeddedMode || !m_webview || !m_widget || m_loading
+        || m_webChannelTransport || m_pageMetricsObserver)
+        return false;
+
+    m_hibernation = Hibernating;
+    m_hibernationTimer.stop();
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    HibernationCallback *callback = new HibernationCallback{ this };
+    // A lambda of the class, completeHibernation() is private
+    QLinuxGtkThread::post([webview, callback]() {
+        webkit_web_view_get_snapshot(
+                webview, WEBKIT_SNAPSHOT_REGION_VISIBLE, WEBKIT_SNAPSHOT_OPTIONS_NONE, nullptr,
+                +[](GObject *object, GAsyncResult *result, gpointer userData) {
+                    QScopedPointer<HibernationCallback> callback(
+                            static_cast<HibernationCallback *>(userData));
+                    cairo_surface_t *surface = webkit_web_view_get_snapshot_finish(
+                            WEBKIT_WEB_VIEW(object), result, nullptr);
+                    QImage image;
+                    if (surface) {
+                        image = imageFromSurface(surface);
+                        cairo_surface_destroy(surface);
+                    }
+                    // Hibernates without a snapshot when there is none
+                    deliverToView(callback->view, [image](QLinuxWebViewPrivate *view) {
+                        view->completeHibernation(image);
+                    });
+                },
+                callback);
+    });
+    return true;
+}
+
+void QLinuxWebViewPrivate::completeHibernation(const QImage &snapshot)
+{
+    // Woken up or put to use while the snapshot was taken
+    if (m_hibernation != Hibernating)
+        return;
+    if (!m_webview || m_loading || m_webChannelTransport || m_pageMetricsObserver) {
+        m_hibernation = Awake;
+        return;
+    }
+
+    m_hibernationSnapshot = snapshot;
+    QLinuxGtkThread::invoke([this]() {
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        m_hibernatedSessionState = serializeSessionState(webview);
+
+        webkit_web_view_stop_loading(webview);
+        g_signal_handlers_disconnect_by_data(webkit_web_view_get_back_forward_list(webview), this);
+        g_signal_handlers_disconnect_by_data(webview, this);
+        // The plug owns the view, and keeps the X window the QWindow wraps
+        gtk_widget_destroy(GTK_WIDGET(webview));
+        m_webview = nullptr;
+
+        GtkWidget *placeholder = gtk_event_box_new();
+        if (!m_hibernationSnapshot.isNull()) {
+            cairo_surface_t *surface = surfaceFromImage(m_hibernationSnapshot);
+            gtk_container_add(GTK_CONTAINER(placeholder), gtk_image_new_from_surface(surface));
+            cairo_surface_destroy(surface);
+        }
+        g_signal_connect_swapped(placeholder, "button-press-event",
+                                 G_CALLBACK(+[](QLinuxWebViewPrivate *instance) -> gboolean {
+                                     QLinuxGtkThread::deliver(instance,
+                                                              [instance]() { instance->touch(); });
+                                     return true;
+                                 }),
+                                 this);
+        gtk_container_add(GTK_CONTAINER(m_widget), placeholder);
+        gtk_widget_show_all(GTK_WIDGET(m_widget));
+        m_placeholder = placeholder;
+    });
+
+    m_hibernation = Hibernated;
+    emit hibernationChanged(true);
+}
+
+void QLinuxWebViewPrivate::wake()
+{
+    if (m_hibernation == Hibernating) {
+        // The snapshot is dropped once it arrives
+        m_hibernation = Awake;
+        return;
+    }
+    if (m_hibernation != Hibernated)
+        return;
+
+    QLinuxGtkThread::invoke([this]() {
+        gtk_widget_destroy(GTK_WIDGET(m_placeholder));
+        m_placeholder = nullptr;
+        if (!createWebKitView())
+            return;
+
+        WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+        if (m_httpUserAgent != m_defaultUserAgent)
+            webkit_settings_set_user_agent(webkit_web_view_get_settings(webview),
+                                           m_httpUserAgent.toUtf8().constData());
+        gtk_container_add(GTK_CONTAINER(m_widget), GTK_WIDGET(webview));
+        gtk_widget_show_all(GTK_WIDGET(m_widget));
+        connectWebViewCallbacks();
+
+        if (!restoreSessionState(webview, m_hibernatedSessionState) && m_url.isValid())
+            webkit_web_view_load_uri(webview, m_url.toString().toUtf8().constData());
+    });
+
+    m_hibernation = Awake;
+    m_hibernationSnapshot = QImage();
+    m_hibernatedSessionState.clear();
+    emit hibernationChanged(false);
+}
+
+QByteArray QLinuxWebViewPrivate::saveState() const
+{
+    if (m_hibernation == Hibernated)
+        return m_hibernatedSessionState;
+    if (!m_webview)
+        return QByteArray();
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    QByteArray state;
+    QLinuxGtkThread::invoke([webview, &state]() { state = serializeSessionState(webview); });
+    return state;
+}
+
+bool QLinuxWebViewPrivate::restoreState(const QByteArray &state)
+{
+    touch();
+    if (!m_webview || state.isEmpty())
+        return false;
+
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    bool restored = false;
+    QLinuxGtkThread::invoke([webview, &state, &restored]() {
+        restored = restoreSessionState(webview, state);
+    });
+    return restored;
+}
+
+void QLinuxWebViewPrivate::hibernateBackgroundViews()
+{
+    // Hibernation emits signals, the list may change meanwhile
+    const QList<QLinuxWebViewPrivate *> views = embeddedViews();
+    for (QLinuxWebViewPrivate *view : views) {
+        if (embeddedViews().contains(view) && view->hibernationIdleTime() > 0
+            && view->isInBackground())
+            view->hibernate();
+    }
+}
 
 QAbstractWebViewSettings *QLinuxWebViewPrivate::getSettings() const
 {
@@ -319,18 +1231,92 @@ QAbstractWebViewSettings *QLinuxWebViewPrivate::getSettings() const
 
 void QLinuxWebViewPrivate::urlChangedCallback()
 {
-    m_url = webkit_web_view_get_uri(static_cast<WebKitWebView *>(m_webview));
-    emit urlChanged(QUrl(m_url));
+    Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QLinuxWebViewPrivate::urlChangedCallback", m_navigation.id);
+    if (m_resetLoadPending || m_navigation.reset)
+        return;
+    const QUrl url(
+            QString::fromUtf8(webkit_web_view_get_uri(static_cast<WebKitWebView *>(m_webview))));
+    QLinuxGtkThread::deliver(this, [this, url]() {
+        m_url = url;
+        emit urlChanged(url);
+    });
 }
 
 void QLinuxWebViewPrivate::titleChangedCallback()
 {
-    emit titleChanged(title());
+    Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QLinuxWebViewPrivate::titleChangedCallback", m_navigation.id);
+    if (m_resetLoadPending || m_navigation.reset)
+        return;
+    const QString title =
+            QString::fromUtf8(webkit_web_view_get_title(static_cast<WebKitWebView *>(m_webview)));
+    QLinuxGtkThread::deliver(this, [this, title]() {
+        m_title = title;
+        emit titleChanged(title);
+    });
 }
 
 void QLinuxWebViewPrivate::loadProgressCallback()
 {
-    emit loadProgressChanged(loadProgress());
+    Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QLinuxWebViewPrivate::loadProgressCallback", m_navigation.id);
+    if (m_resetLoadPending || m_navigation.reset)
+        return;
+    const int progress = int(webkit_web_view_get_estimated_load_progress(
+                                     static_cast<WebKitWebView *>(m_webview))
+                             * 100);
+    QLinuxGtkThread::deliver(this, [this, progress]() {
+        m_loadProgress = progress;
+        emit loadProgressChanged(progress);
+    });
+}
+
+void QLinuxWebViewPrivate::loadingStateCallback()
+{
+    Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QLinuxWebViewPrivate::loadingStateCallback", m_navigation.id);
+    const bool loading = webkit_web_view_is_loading(static_cast<WebKitWebView *>(m_webview));
+    QLinuxGtkThread::deliver(this, [this, loading]() { m_loading = loading; });
+}
+
+void QLinuxWebViewPrivate::historyChangedCallback()
+{
+    Q_WEBVIEW_TRACE_SPAN("QLinuxWebViewPrivate::historyChangedCallback");
+    WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
+    const bool canGoBack = webkit_web_view_can_go_back(webview);
+    const bool canGoForward = webkit_web_view_can_go_forward(webview);
+    QLinuxGtkThread::deliver(this, [this, canGoBack, canGoForward]() {
+        m_canGoBack = canGoBack;
+        m_canGoForward = canGoForward;
+    });
+}
+
+static quint64 lastNavigationId = 0;
+
+QWebViewLoadRequestPrivate QLinuxWebViewPrivate::navigationRequest(const QUrl &url,
+                                                                   QWebView::LoadStatus status,
+                                                                   const QString &errorString) const
+{
+    QWebViewLoadRequestPrivate request(url, status, errorString);
+    request.m_navigationId = m_navigation.id;
+    request.m_startedAt = m_navigation.startedAt;
+    request.m_redirectedAt = m_navigation.redirectedAt;
+    request.m_committedAt = m_navigation.committedAt;
+    request.m_httpStatusCode = m_navigation.httpStatusCode;
+    return request;
+}
+
+void QLinuxWebViewPrivate::postLoadingChanged(const QWebViewLoadRequestPrivate &request,
+                                              qint64 postedAt)
+{
+    QMetaObject::invokeMethod(
+            this,
+            [this, request, postedAt]() {
+                Q_WEBVIEW_TRACE_QUEUED("QLinuxWebViewPrivate::loadingChanged queued", postedAt,
+                                       request.m_navigationId);
+                Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QLinuxWebViewPrivate::loadingChanged",
+                                                request.m_navigationId);
+                m_navigationId = request.m_navigationId;
+                emit loadingChanged(request);
+            },
+            Qt::QueuedConnection);
 }
 
 void QLinuxWebViewPrivate::loadChangedCallback(uint32_t ev)
@@ -338,30 +1324,59 @@ void QLinuxWebViewPrivate::loadChangedCallback(uint32_t ev)
     WebKitWebView *webview = static_cast<WebKitWebView *>(m_webview);
     WebKitLoadEvent event = static_cast<WebKitLoadEvent>(ev);
 
+    // Taken here rather than when the queued signal is delivered
+    const qint64 now = QDeadlineTimer::current().deadlineNSecs();
     QUrl url(webkit_web_view_get_uri(webview));
 
+    QWebViewLoadRequestPrivate request;
     switch (event) {
     case WEBKIT_LOAD_STARTED:
-        QMetaObject::invokeMethod(
-                this, "loadingChanged", Qt::QueuedConnection,
-                Q_ARG(QWebViewLoadRequestPrivate,
-                      QWebViewLoadRequestPrivate(url, QWebView::LoadStartedStatus, "")));
+        m_navigation = Navigation();
+        m_navigation.id = ++lastNavigationId;
+        m_navigation.startedAt = now;
+        // The blank page of reset(), unless a load of the new owner replaced it
+        m_navigation.reset = m_resetLoadPending && url == QUrl(QStringLiteral("about:blank"));
+        m_resetLoadPending = false;
+        request = navigationRequest(url, QWebView::LoadStartedStatus);
         break;
-    case WEBKIT_LOAD_FINISHED:
-        QMetaObject::invokeMethod(
-                this, "loadingChanged", Qt::QueuedConnection,
-                Q_ARG(QWebViewLoadRequestPrivate,
-                      QWebViewLoadRequestPrivate(url, QWebView::LoadStoppedStatus, "")));
+    case WEBKIT_LOAD_REDIRECTED:
+        m_navigation.redirectedAt = now;
+        request = navigationRequest(url, QWebView::LoadRedirectedStatus);
         break;
-    default:
+    case WEBKIT_LOAD_COMMITTED:
+        m_navigation.committedAt = now;
+        if (WebKitWebResource *resource = webkit_web_view_get_main_resource(webview)) {
+            if (WebKitURIResponse *response = webkit_web_resource_get_response(resource))
+                m_navigation.httpStatusCode = int(webkit_uri_response_get_status_code(response));
+        }
+        request = navigationRequest(url, QWebView::LoadCommittedStatus);
         break;
+    case WEBKIT_LOAD_FINISHED:
+        request = navigationRequest(url, QWebView::LoadStoppedStatus);
+        request.m_finishedAt = now;
+        break;
+    }
+    Q_WEBVIEW_TRACE_NAVIGATION_INSTANT("QLinuxWebViewPrivate::loadChangedCallback",
+                                       request.m_navigationId);
+    if (m_navigation.reset) {
+        // Its last event, the following callbacks belong to the new owner
+        if (event == WEBKIT_LOAD_FINISHED)
+            m_navigation.reset = false;
+        return;
     }
+
+    postLoadingChanged(request, now);
 }
 
 void QLinuxWebViewPrivate::loadFailedCallback(uint32_t ev, const char *url, const char *message)
 {
-    QMetaObject::invokeMethod(
-            this, "loadingChanged", Qt::QueuedConnection,
-            Q_ARG(QWebViewLoadRequestPrivate,
-                  QWebViewLoadRequestPrivate(QUrl(url), QWebView::LoadFailedStatus, message)));
+    if (m_navigation.reset)
+        return;
+    const qint64 now = QDeadlineTimer::current().deadlineNSecs();
+    QWebViewLoadRequestPrivate request =
+            navigationRequest(QUrl(url), QWebView::LoadFailedStatus, message);
+    request.m_finishedAt = now;
+    Q_WEBVIEW_TRACE_NAVIGATION_INSTANT("QLinuxWebViewPrivate::loadFailedCallback",
+                                       request.m_navigationId);
+    postLoadingChanged(request, now);
 }
@@ -5,12 +5,19 @@
 #define QLINUXWEBVIEW_P_H
 
 #include <qabstractwebview_p.h>
+#include <qwebviewloadrequest_p.h>
 
 #include <QMap>
 #include <QPointer>
+#include <QTimer>
+#include <QWindow>
 
 QT_BEGIN_NAMESPACE
 
+class QLinuxPageMetricsObserver;
+class QLinuxWebChannelTransport;
+class QLinuxWebContext;
+
 class QLinuxWebViewSettingsPrivate final : public QAbstractWebViewSettings
 {
     Q_OBJECT
@@ -38,9 +45,21 @@ class QLinuxWebViewPrivate : public QAbstractWebView
 {
     Q_OBJECT
 public:
-    explicit QLinuxWebViewPrivate(QObject *parent = nullptr);
+    enum Mode {
+        EmbeddedMode, // GtkPlug shown through a foreign QWindow
+        OffscreenMode // GtkOffscreenWindow of a fixed size, no native window
+    };
+
+    explicit QLinuxWebViewPrivate(QLinuxWebContext *context, QObject *parent = nullptr);
+    QLinuxWebViewPrivate(QLinuxWebContext *context, Mode mode, QObject *parent = nullptr);
     ~QLinuxWebViewPrivate() override;
 
+    Mode mode() const { return m_mode; }
+    // Offscreen mode only
+    QSize offscreenSize() const { return m_offscreenSize; }
+    void setOffscreenSize(const QSize &size);
+    QImage renderFrame() const;
+
     QString httpUserAgent() const override;
     void setHttpUserAgent(const QString &userAgent) override;
     void setUrl(const QUrl &url) override;
@@ -51,6 +70,37 @@ public:
     bool isLoading() const override;
 
     QWindow *nativeWindow() const override;
+    bool reset() override;
+    // WebKit's serialized session state; restoring wakes a hibernated view
+    QByteArray saveState() const override;
+    bool restoreState(const QByteArray &state) override;
+    QWebChannelAbstractTransport *webChannelTransport() override;
+    bool setPageMetricsEnabled(bool enabled) override;
+    void grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId) override;
+
+    QLinuxWebContext *webContext() const { return m_context; }
+
+    // Hibernation frees the WebKit view, and with it usually the web process,
+    // of an embedded view while it is in the background. The session state is
+    // kept and the last snapshot is shown instead, until the view is clicked or
+    // used through the API, which restores the page. The getters keep returning
+    // the last state meanwhile.
+    //
+    // Views hibernate once hidden for the idle time, which defaults to
+    // QT_WEBVIEW_LINUX_HIBERNATE_AFTER, and on low memory warnings; 0 disables it.
+    // Views that are loading or have a web channel or page metrics are skipped,
+    // as are views never shown and views waiting in the pool.
+    int hibernationIdleTime() const { return m_hibernationTimer.interval(); }
+    void setHibernationIdleTime(int msecs);
+    bool isHibernated() const { return m_hibernation == Hibernated; }
+    // Returns false if the view cannot hibernate now, completes asynchronously
+    bool hibernate();
+    void wake();
+    // Hibernates the hidden views that have hibernation enabled
+    static void hibernateBackgroundViews();
+
+Q_SIGNALS:
+    void hibernationChanged(bool hibernated);
 
 public Q_SLOTS:
     void goBack() override;
@@ -58,11 +108,14 @@ public Q_SLOTS:
     void reload() override;
     void stop() override;
     void loadHtml(const QString &html, const QUrl &baseUrl = QUrl()) override;
+    void loadData(const QByteArray &data, const QString &mimeType, const QString &encoding,
+                  const QUrl &baseUrl) override;
     void setCookie(const QString &domain, const QString &name, const QString &value) override;
     void deleteCookie(const QString &domain, const QString &name) override;
     void deleteAllCookies() override;
 
 private Q_SLOTS:
+    void scheduleWindowGeometryUpdate();
     void updateWindowGeometry();
     void initialize(void *hWnd);
 
@@ -71,18 +124,79 @@ protected:
     QAbstractWebViewSettings *getSettings() const override;
 
 private:
+    bool createWebKitView();
+    void createNativeWindow();
+    void connectCallbacks();
+    void connectWebViewCallbacks();
+    bool isWindowVisible() const { return m_window && m_window->isVisible(); }
+    // Hidden after it was shown, and not waiting in the pool
+    bool isInBackground() const { return m_shown && !m_pooled && !isWindowVisible(); }
+    void leavePool();
+    void touch();
+    void completeHibernation(const QImage &snapshot);
     void urlChangedCallback();
     void titleChangedCallback();
     void loadProgressCallback();
+    void loadingStateCallback();
+    void historyChangedCallback();
     void loadChangedCallback(uint32_t ev);
     void loadFailedCallback(uint32_t ev, const char *url, const char *message);
 
 private:
+    Mode m_mode;
+    QSize m_offscreenSize;
+    QLinuxWebContext *m_context;
     void *m_webview; // WebKitWebView
     void *m_widget; // GtkWidget
+    WId m_plugId = 0;
     QLinuxWebViewSettingsPrivate *m_settings;
-    QWindow *m_window;
+    QPointer<QWindow> m_window;
+    // Size changes of the window are applied at most once per event loop pass,
+    // or once the size has settled when QT_WEBVIEW_RESIZE_SETTLE_TIME is set.
+    QTimer m_geometryTimer;
+    QSize m_appliedSize;
+    void *m_pristineSessionState = nullptr; // WebKitWebViewSessionState
+    QString m_defaultUserAgent;
+
+    // Copy of the WebKit state for the getters, which must not wait on the
+    // GTK thread. Kept up to date by the callbacks.
     QUrl m_url;
+    QString m_title;
+    QString m_httpUserAgent;
+    int m_loadProgress = 0;
+    bool m_loading = false;
+    bool m_canGoBack = false;
+    bool m_canGoForward = false;
+    quint64 m_navigationId = 0;
+
+    // Timing of the current navigation, see QWebViewLoadRequestPrivate.
+    // Only used on the GTK thread.
+    struct Navigation
+    {
+        quint64 id = 0;
+        qint64 startedAt = 0;
+        qint64 redirectedAt = 0;
+        qint64 committedAt = 0;
+        int httpStatusCode = 0;
+        bool reset = false; // the blank page loaded by reset(), hidden from the owner
+    } m_navigation;
+    // reset() requested its blank page, which has not started yet. GTK thread only.
+    bool m_resetLoadPending = false;
+    QWebViewLoadRequestPrivate navigationRequest(const QUrl &url, QWebView::LoadStatus status,
+                                                 const QString &errorString = QString()) const;
+    // Emits loadingChanged() on the GUI thread, postedAt is when the GTK thread got the event
+    void postLoadingChanged(const QWebViewLoadRequestPrivate &request, qint64 postedAt);
+    QLinuxWebChannelTransport *m_webChannelTransport = nullptr;
+    QLinuxPageMetricsObserver *m_pageMetricsObserver = nullptr;
+
+    enum Hibernation { Awake, Hibernating, Hibernated };
+    Hibernation m_hibernation = Awake;
+    QTimer m_hibernationTimer;
+    QImage m_hibernationSnapshot;
+    QByteArray m_hibernatedSessionState; // serialized WebKitWebViewSessionState
+    void *m_placeholder = nullptr; // GtkWidget showing the snapshot
+    bool m_shown = false; // the window was visible at least once
+    bool m_pooled = false; // reset for the pool, until used again
 };
 
 QT_END_NAMESPACE
@@ -2,16 +2,208 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qlinuxwebviewplugin.h"
+#include "qlinuxgtkthread_p.h"
+#include "qlinuxprocessmonitor_p.h"
 #include "qlinuxwebview_p.h"
+#include "qlinuxwebprofile_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+struct WebContextPool
+{
+    ~WebContextPool() { qDeleteAll(contexts); }
+
+    struct UrlScheme
+    {
+        QByteArray scheme;
+        QLinuxUrlSchemeHandler handler;
+        QLinuxWebContext::UrlSchemeFlags flags;
+    };
+
+    QLinuxWebContextOptions options = QLinuxWebContextOptions::fromEnvironment();
+    QList<QLinuxWebContext *> contexts;
+    QList<UrlScheme> urlSchemes;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(WebContextPool, webContextPool)
+
+// "webview" gives an embedded view unless QT_WEBVIEW_LINUX_OFFSCREEN is set,
+// "offscreen-webview" always an offscreen one.
+static bool viewModeForKey(const QString &key, QLinuxWebViewPrivate::Mode *mode)
+{
+    if (key == QLatin1String("offscreen-webview")) {
+        *mode = QLinuxWebViewPrivate::OffscreenMode;
+        return true;
+    }
+    if (key == QLatin1String("webview")) {
+        *mode = qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_OFFSCREEN")
+                ? QLinuxWebViewPrivate::OffscreenMode
+                : QLinuxWebViewPrivate::EmbeddedMode;
+        return true;
+    }
+    return false;
+}
+
 QAbstractWebView *QLinuxWebViewPlugin::create(const QString &key, QObject *parent) const
 {
-    return (key == QLatin1String("webview")) ? new QLinuxWebViewPrivate(parent) : nullptr;
+    QLinuxWebViewPrivate::Mode mode;
+    if (!viewModeForKey(key, &mode))
+        return nullptr;
+    return new QLinuxWebViewPrivate(acquireContext(), mode, parent);
+}
+
+QAbstractWebView *QLinuxWebViewPlugin::create(const QString &key, QObject *profile,
+                                              QObject *parent) const
+{
+    if (!profile)
+        return create(key, parent);
+    QLinuxWebViewPrivate::Mode mode;
+    if (!viewModeForKey(key, &mode))
+        return nullptr;
+
+    QLinuxWebProfile *webProfile = qobject_cast<QLinuxWebProfile *>(profile);
+    if (!webProfile) {
+        qWarning() << "Ignoring unsupported profile" << profile;
+        return create(key, parent);
+    }
+
+    QLinuxWebContext *context = webProfile->webContext();
+    context->attachView();
+    return new QLinuxWebViewPrivate(context, mode, parent);
+}
+
+static void schedulePrewarm()
+{
+    // After the events queued during startup, the first window is up by then
+    QTimer::singleShot(0, QCoreApplication::instance(), &QLinuxWebViewPlugin::prewarm);
+}
+
+void QLinuxWebViewPlugin::prepare() const
+{
+    // GTK itself is initialized by the first view, or by the prewarm. Doing it
+    // here would put it on the startup path of every application.
+    if (!contextOptions().prewarm)
+        return;
+
+    // The registry prepares the plugin at startup when prewarming, for static
+    // builds that is before the application object exists.
+    if (QCoreApplication::instance())
+        schedulePrewarm();
+    else
+        qAddPreRoutine(schedulePrewarm);
+}
+
+QLinuxWebContextOptions QLinuxWebViewPlugin::contextOptions()
+{
+    return webContextPool->options;
+}
+
+void QLinuxWebViewPlugin::setContextOptions(const QLinuxWebContextOptions &options)
+{
+    WebContextPool *pool = webContextPool();
+    pool->options = options;
+    const QString cookieStoragePath = options.effectiveCookieStoragePath();
+    QLinuxGtkThread::invoke([pool, &options, &cookieStoragePath]() {
+        const QList<QLinuxWebContext *> &contexts = pool->contexts;
+        for (QLinuxWebContext *context : contexts) {
+            context->setProcessModel(options.processModel);
+            context->setWebProcessCountLimit(options.webProcessCountLimit);
+            context->setCacheModel(options.cacheModel);
+            context->setCookieStoragePath(cookieStoragePath);
+        }
+    });
 }
 
-void QLinuxWebViewPlugin::prepare() const { }
+QList<QLinuxWebContext *> QLinuxWebViewPlugin::contexts()
+{
+    return webContextPool->contexts;
+}
+
+QLinuxWebContext *QLinuxWebViewPlugin::acquireContext()
+{
+    WebContextPool *pool = webContextPool();
+
+    // Shared mode keeps every view in one context; partitioned mode fills the
+    // least used context up to viewsPerContext before opening a new one.
+    QLinuxWebContext *context = nullptr;
+    const QList<QLinuxWebContext *> &contexts = pool->contexts;
+    for (QLinuxWebContext *candidate : contexts) {
+        if (pool->options.viewsPerContext > 0
+            && candidate->viewCount() >= pool->options.viewsPerContext)
+            continue;
+        if (!context || candidate->viewCount() < context->viewCount())
+            context = candidate;
+    }
+
+    if (!context) {
+        context = new QLinuxWebContext;
+        initializeContext(context);
+        pool->contexts.append(context);
+    }
+
+    context->attachView();
+    return context;
+}
+
+void QLinuxWebViewPlugin::releaseContext(QLinuxWebContext *context)
+{
+    // Contexts are kept alive once created, the web and network processes they
+    // own are the expensive part and will be reused by the next view.
+    if (context)
+        context->detachView();
+}
+
+QLinuxProcessMonitor *QLinuxWebViewPlugin::processMonitor()
+{
+    static QPointer<QLinuxProcessMonitor> monitor;
+    if (!monitor)
+        monitor = new QLinuxProcessMonitor(QCoreApplication::instance());
+    return monitor;
+}
+
+void QLinuxWebViewPlugin::prewarm()
+{
+    QLinuxWebContext *context = acquireContext();
+    QLinuxGtkThread::post([context]() {
+        QLinuxGtkThread::initializeGtk();
+        context->prewarm();
+    });
+    releaseContext(context);
+}
+
+void QLinuxWebViewPlugin::initializeContext(QLinuxWebContext *context)
+{
+    const WebContextPool *pool = webContextPool();
+    context->setProcessModel(pool->options.processModel);
+    context->setWebProcessCountLimit(pool->options.webProcessCountLimit);
+    context->setCacheModel(pool->options.cacheModel);
+    // Resolved here, the options may be read before the application name is set
+    context->setCookieStoragePath(pool->options.effectiveCookieStoragePath());
+    const QList<WebContextPool::UrlScheme> &urlSchemes = pool->urlSchemes;
+    for (const WebContextPool::UrlScheme &urlScheme : urlSchemes)
+        context->registerUrlScheme(urlScheme.scheme, urlScheme.handler, urlScheme.flags);
+}
+
+void QLinuxWebViewPlugin::registerUrlScheme(const QByteArray &scheme,
+                                            const QLinuxUrlSchemeHandler &handler,
+                                            QLinuxWebContext::UrlSchemeFlags flags)
+{
+    WebContextPool *pool = webContextPool();
+    pool->urlSchemes.append({ scheme, handler, flags });
+    QLinuxGtkThread::invoke([pool, &scheme, &handler, flags]() {
+        const QList<QLinuxWebContext *> &contexts = pool->contexts;
+        for (QLinuxWebContext *context : contexts)
+            context->registerUrlScheme(scheme, handler, flags);
+    });
+}
 
 QT_END_NAMESPACE
 
@@ -17,19 +17,44 @@
 
 #include "qwebviewplugin_p.h"
 #include "qabstractwebview_p.h"
+#include "qlinuxwebcontext_p.h"
 
+#include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
 
 QT_BEGIN_NAMESPACE
 
+class QLinuxProcessMonitor;
+
 class QLinuxWebViewPlugin : public QWebViewPlugin
 {
     Q_OBJECT
 
 public:
     QAbstractWebView *create(const QString &key, QObject *parent = nullptr) const override;
+    // profile is a QLinuxWebProfile
+    QAbstractWebView *create(const QString &key, QObject *profile, QObject *parent) const override;
 
     void prepare() const override;
+
+    // Web contexts shared by all views created through this plugin
+    static QLinuxWebContextOptions contextOptions();
+    static void setContextOptions(const QLinuxWebContextOptions &options);
+    static QList<QLinuxWebContext *> contexts();
+    static QLinuxWebContext *acquireContext();
+    static void releaseContext(QLinuxWebContext *context);
+    // Shared by all views, created on first use and deleted with the application.
+    // GUI thread only.
+    static QLinuxProcessMonitor *processMonitor();
+    // Initializes GTK and starts the web process of a shared context
+    static void prewarm();
+    // Applies the context options and URL schemes to a context created elsewhere
+    static void initializeContext(QLinuxWebContext *context);
+
+    // Registered on every shared context, and on profile contexts created later
+    static void registerUrlScheme(const QByteArray &scheme, const QLinuxUrlSchemeHandler &handler,
+                                  QLinuxWebContext::UrlSchemeFlags flags =
+                                          QLinuxWebContext::SecureScheme);
 };
 
 QT_END_NAMESPACE
@@ -27,6 +27,8 @@ class QWebView2WebViewPlugin : public QWebViewPlugin
     Q_OBJECT
 
 public:
+    // The profile overload, not overridden
+    using QWebViewPlugin::create;
     QAbstractWebView *create(const QString &key, QObject *parent = nullptr) const override;
 
     void prepare() const override;
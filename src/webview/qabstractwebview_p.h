@@ -16,9 +16,11 @@
 //
 
 #include "qwebviewinterface_p.h"
+#include "qwebviewpagemetrics_p.h"
 
 QT_BEGIN_NAMESPACE
 
+class QWebChannelAbstractTransport;
 class QWebView;
 class QWebViewSettings;
 class QWebViewLoadRequestPrivate;
@@ -47,6 +49,11 @@ class Q_WEBVIEW_EXPORT QAbstractWebView
     Q_OBJECT
 
 public:
+    enum SnapshotRegion {
+        VisibleSnapshotRegion,
+        FullDocumentSnapshotRegion
+    };
+
     virtual QAbstractWebViewSettings *getSettings() const = 0;
     virtual QString httpUserAgent() const = 0;
     virtual void setHttpUserAgent(const QString &httpUserAgent) = 0;
@@ -61,11 +68,55 @@ public:
     virtual void stop() = 0;
     virtual void reload() = 0;
     virtual void loadHtml(const QString &html, const QUrl &baseUrl) = 0;
+    // Loads the bytes as is, backends override this to avoid the conversion
+    // to QString and the copies that come with it.
+    virtual void loadData(const QByteArray &data, const QString &mimeType,
+                          const QString &encoding, const QUrl &baseUrl)
+    {
+        const bool utf8 = encoding.isEmpty()
+                || encoding.compare(QLatin1String("utf-8"), Qt::CaseInsensitive) == 0;
+        if (mimeType == QLatin1String("text/html") && utf8) {
+            loadHtml(QString::fromUtf8(data), baseUrl);
+            return;
+        }
+        QString dataUrl = QLatin1String("data:") + mimeType;
+        if (!encoding.isEmpty())
+            dataUrl += QLatin1String(";charset=") + encoding;
+        dataUrl += QLatin1String(";base64,") + QLatin1String(data.toBase64());
+        setUrl(QUrl(dataUrl));
+    }
     virtual void runJavaScriptPrivate(const QString &script, int callbackId) = 0;
     virtual void setCookie(const QString &domain, const QString &name, const QString &value) = 0;
     virtual void deleteCookie(const QString &domain, const QString &name) = 0;
     virtual void deleteAllCookies() = 0;
     virtual QWindow *nativeWindow() const = 0;
+    // Brings the backend back to a blank state so it can be handed out again,
+    // returns false if the backend cannot be reused.
+    virtual bool reset() { return false; }
+    // Opaque state with the back/forward list, for restoreState() in a later run.
+    // Empty if the backend cannot save its state.
+    virtual QByteArray saveState() const { return QByteArray(); }
+    // Replaces the history with a saved one and loads its current item.
+    // Returns false if the state is not understood, nothing is loaded then.
+    virtual bool restoreState(const QByteArray &state)
+    {
+        Q_UNUSED(state);
+        return false;
+    }
+    // Transport for QWebChannel, nullptr if the backend has none
+    virtual QWebChannelAbstractTransport *webChannelTransport() { return nullptr; }
+    // Opt-in, pageMetricsReceived() is emitted once per navigation while enabled.
+    // Returns false if the backend cannot collect metrics.
+    virtual bool setPageMetricsEnabled(bool enabled) { return !enabled; }
+    // Answered by snapshotReady() with the same callbackId, a null image on failure.
+    // A valid targetSize scales the snapshot down to fit, keeping the aspect ratio.
+    virtual void grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId)
+    {
+        Q_UNUSED(region);
+        Q_UNUSED(targetSize);
+        QMetaObject::invokeMethod(this, "snapshotReady", Qt::QueuedConnection,
+                                  Q_ARG(int, callbackId), Q_ARG(QImage, QImage()));
+    }
     // NOTE: This is a temporary solution for WASM and should
     // be removed once window containers are supported.
 #if defined(Q_OS_WASM) || 1
@@ -83,6 +134,8 @@ Q_SIGNALS:
     void cookieAdded(const QString &domain, const QString &name);
     void cookieRemoved(const QString &domain, const QString &name);
     void nativeWindowChanged(QWindow *window);
+    void pageMetricsReceived(const QWebViewPageMetrics &metrics);
+    void snapshotReady(int callbackId, const QImage &image);
 
 protected:
     explicit QAbstractWebView(QObject *p = nullptr) : QObject(p) { }
@@ -24,13 +24,12 @@ QT_BEGIN_NAMESPACE
 
 static void initializeImpl()
 {
+    // Backends that do not ask for early initialization are loaded and prepared
+    // the first time a view is created, so startup does not pay for them.
     if (QWebViewFactory::requiresExtraInitializationSteps()) {
-        // There might be plugins available, but their dependencies might not be met,
-        // so make sure we have a valid plugin before using it.
-        // Note: A warning will be printed later if we're unable to load the plugin.
-        QWebViewPlugin *plugin = QWebViewFactory::getPlugin();
-        if (plugin)
-            plugin->prepare();
+        // Loading the plugin prepares it.
+        // Note: A warning will be printed if we're unable to load the plugin.
+        QWebViewFactory::getPlugin();
     }
 }
 
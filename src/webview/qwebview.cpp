@@ -5,13 +5,97 @@
 #include "qwebviewplugin_p.h"
 #include "qwebviewloadrequest_p.h"
 #include "qwebviewfactory_p.h"
+#include "qwebviewtrace_p.h"
 
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qthread.h>
+
+#include <climits>
 
 QT_BEGIN_NAMESPACE
 
+// "QWVS", followed by the format version
+static const quint32 stateMagic = 0x51575653;
+static const quint32 stateVersion = 1;
+
+// Restoring many views at startup would start all their loads, and web
+// processes, at once. They are restored a batch at a time instead, in the
+// order restoreState() was called.
+class QWebViewRestoreQueue : public QObject
+{
+public:
+    static void enqueue(QWebView *view, const QUrl &url, const QByteArray &backendState)
+    {
+        static quint64 lastId = 0;
+        view->m_pendingRestore = ++lastId;
+        view->m_pendingRestoreUrl = url;
+        view->m_pendingRestoreState = backendState;
+
+        static QPointer<QWebViewRestoreQueue> queue;
+        if (!queue)
+            queue = new QWebViewRestoreQueue;
+        queue->m_entries.enqueue(Entry{ view, view->m_pendingRestore,
+                                        QDeadlineTimer::current().deadlineNSecs() });
+        // Views set up in the same pass of the event loop start together
+        if (!queue->m_timer.isActive())
+            queue->m_timer.start(0);
+    }
+
+private:
+    struct Entry
+    {
+        QPointer<QWebView> view;
+        quint64 id;
+        qint64 queuedAt; // nsecs
+    };
+
+    QWebViewRestoreQueue() : QObject(QCoreApplication::instance())
+    {
+        const int batchSize = qEnvironmentVariableIntValue("QT_WEBVIEW_RESTORE_BATCH_SIZE");
+        m_batchSize = batchSize > 0 ? batchSize : qMax(1, QThread::idealThreadCount() / 2);
+        const int interval = qEnvironmentVariableIntValue("QT_WEBVIEW_RESTORE_INTERVAL");
+        m_interval = interval > 0 ? interval : 250;
+
+        m_timer.setSingleShot(true);
+        connect(&m_timer, &QTimer::timeout, this, [this]() { runBatch(); });
+    }
+
+    void runBatch()
+    {
+        Q_WEBVIEW_TRACE_SPAN("QWebViewRestoreQueue::runBatch");
+        int restored = 0;
+        while (restored < m_batchSize && !m_entries.isEmpty()) {
+            const Entry entry = m_entries.dequeue();
+            // Deleted, navigated, or restored again meanwhile
+            if (!entry.view || entry.view->m_pendingRestore != entry.id)
+                continue;
+            Q_WEBVIEW_TRACE_QUEUED("QWebView::restoreState queued", entry.queuedAt, 0);
+            entry.view->applyPendingRestore();
+            ++restored;
+        }
+        if (!m_entries.isEmpty())
+            m_timer.start(m_interval);
+    }
+
+    QQueue<Entry> m_entries;
+    QTimer m_timer;
+    int m_batchSize;
+    int m_interval; // msecs
+};
+
 QWebView::QWebView(QObject *p)
+    : QWebView(nullptr, p)
+{
+}
+
+QWebView::QWebView(QObject *profile, QObject *p)
     : QAbstractWebView(p)
-    , d(QWebViewFactory::createWebView())
+    , d(QWebViewFactory::createWebView(profile, nullptr))
     , m_settings(new QWebViewSettings(d->getSettings()))
     , m_progress(0)
 {
@@ -24,13 +108,25 @@ QWebView::QWebView(QObject *p)
     connect(d, &QAbstractWebView::loadProgressChanged, this, &QWebView::onLoadProgressChanged);
     connect(d, &QAbstractWebView::httpUserAgentChanged, this, &QWebView::onHttpUserAgentChanged);
     connect(d, &QAbstractWebView::javaScriptResult,
-            this, &QWebView::javaScriptResult);
+            this, &QWebView::onJavaScriptResult);
     connect(d, &QAbstractWebView::cookieAdded, this, &QWebView::cookieAdded);
     connect(d, &QAbstractWebView::cookieRemoved, this, &QWebView::cookieRemoved);
+    connect(d, &QAbstractWebView::pageMetricsReceived, this,
+            &QAbstractWebView::pageMetricsReceived);
+    connect(d, &QAbstractWebView::snapshotReady, this, &QAbstractWebView::snapshotReady);
+
+    m_notificationTimer.setSingleShot(true);
+    m_notificationTimer.setInterval(
+            qMax(0, qEnvironmentVariableIntValue("QT_WEBVIEW_NOTIFICATION_INTERVAL")));
+    connect(&m_notificationTimer, &QTimer::timeout, this, &QWebView::flushNotifications);
 }
 
 QWebView::~QWebView()
 {
+    disconnect(d, nullptr, this, nullptr);
+    if (QWebViewFactory::recycleWebView(d))
+        d = nullptr;
+    delete m_settings;
 }
 
 QString QWebView::httpUserAgent() const
@@ -43,6 +139,7 @@ QString QWebView::httpUserAgent() const
 
 void QWebView::setHttpUserAgent(const QString &userAgent)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::setHttpUserAgent");
     return d->setHttpUserAgent(userAgent);
 }
 
@@ -53,6 +150,8 @@ QUrl QWebView::url() const
 
 void QWebView::setUrl(const QUrl &url)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::setUrl");
+    cancelRestore();
     d->setUrl(url);
 }
 
@@ -63,6 +162,8 @@ bool QWebView::canGoBack() const
 
 void QWebView::goBack()
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::goBack");
+    cancelRestore();
     d->goBack();
 }
 
@@ -73,16 +174,25 @@ bool QWebView::canGoForward() const
 
 void QWebView::goForward()
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::goForward");
+    cancelRestore();
     d->goForward();
 }
 
 void QWebView::reload()
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::reload");
+    // Nothing is loaded yet, the restore is what there is to reload
+    if (m_pendingRestore) {
+        applyPendingRestore();
+        return;
+    }
     d->reload();
 }
 
 void QWebView::stop()
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::stop");
     d->stop();
 }
 
@@ -111,76 +221,284 @@ QWindow *QWebView::nativeWindow() const
     return d->nativeWindow();
 }
 
+QWebChannelAbstractTransport *QWebView::webChannelTransport()
+{
+    return d->webChannelTransport();
+}
+
+bool QWebView::setPageMetricsEnabled(bool enabled)
+{
+    if (!d->setPageMetricsEnabled(enabled))
+        return false;
+    m_pageMetricsEnabled = enabled;
+    return true;
+}
+
+void QWebView::grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::grabSnapshot");
+    d->grabSnapshot(region, targetSize, callbackId);
+}
+
+QByteArray QWebView::saveState() const
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::saveState");
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    // A queued restore has not reached the backend yet, its state is still the one to keep
+    stream << stateMagic << stateVersion << m_url << m_title
+           << (m_pendingRestore ? m_pendingRestoreState : d->saveState());
+    return state;
+}
+
+bool QWebView::restoreState(const QByteArray &state)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::restoreState");
+    QDataStream stream(state);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != stateMagic || version != stateVersion) {
+        qWarning("QWebView::restoreState: not a saved WebView state");
+        return false;
+    }
+    QUrl url;
+    QString title;
+    QByteArray backendState;
+    stream >> url >> title >> backendState;
+    if (stream.status() != QDataStream::Ok) {
+        qWarning("QWebView::restoreState: truncated WebView state");
+        return false;
+    }
+
+    // Shown until the queued restore loads the page
+    onUrlChanged(url);
+    onTitleChanged(title);
+    QWebViewRestoreQueue::enqueue(this, url, backendState);
+    return true;
+}
+
+void QWebView::applyState(const QUrl &url, const QByteArray &backendState)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::applyState");
+    // The state may come from another backend, or from before an engine update
+    if (!backendState.isEmpty() && d->restoreState(backendState))
+        return;
+    if (url.isValid())
+        d->setUrl(url);
+}
+
+void QWebView::cancelRestore()
+{
+    m_pendingRestore = 0;
+    m_pendingRestoreUrl.clear();
+    m_pendingRestoreState.clear();
+}
+
+void QWebView::applyPendingRestore()
+{
+    const QUrl url = m_pendingRestoreUrl;
+    const QByteArray backendState = m_pendingRestoreState;
+    cancelRestore();
+    applyState(url, backendState);
+}
+
 void QWebView::loadHtml(const QString &html, const QUrl &baseUrl)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::loadHtml");
+    cancelRestore();
     d->loadHtml(html, baseUrl);
 }
 
+void QWebView::loadData(const QByteArray &data, const QString &mimeType,
+                        const QString &encoding, const QUrl &baseUrl)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::loadData");
+    cancelRestore();
+    d->loadData(data, mimeType, encoding, baseUrl);
+}
+
 void QWebView::runJavaScriptPrivate(const QString &script,
                                     int callbackId)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::runJavaScriptPrivate");
     d->runJavaScriptPrivate(script, callbackId);
 }
 
+void QWebView::runJavaScriptBatch(const QStringList &scripts, int callbackId)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::runJavaScriptBatch");
+    // Each entry is evaluated in the global scope, like a single runJavaScript() call,
+    // and its exception is caught so the remaining entries still run.
+    static const QString wrapper = QStringLiteral(
+            "(function(scripts) {"
+            "    var results = [];"
+            "    for (var i = 0; i < scripts.length; ++i) {"
+            "        try {"
+            "            results.push({ value: (0, eval)(scripts[i]) });"
+            "        } catch (e) {"
+            "            results.push({ error: String(e) });"
+            "        }"
+            "    }"
+            "    return results;"
+            "})(%1)");
+
+    const QByteArray encodedScripts =
+            QJsonDocument(QJsonArray::fromStringList(scripts)).toJson(QJsonDocument::Compact);
+
+    const int batchId = m_nextJavaScriptBatchId;
+    m_nextJavaScriptBatchId = batchId > INT_MIN ? batchId - 1 : -2;
+    m_javaScriptBatches.insert(batchId, qMakePair(callbackId, int(scripts.size())));
+    d->runJavaScriptPrivate(wrapper.arg(QString::fromUtf8(encodedScripts)), batchId);
+}
+
 void QWebView::setCookie(const QString &domain, const QString &name, const QString &value)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::setCookie");
     d->setCookie(domain, name, value);
 }
 
 void QWebView::deleteCookie(const QString &domain, const QString &name)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::deleteCookie");
     d->deleteCookie(domain, name);
 }
 
 void QWebView::deleteAllCookies()
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::deleteAllCookies");
     d->deleteAllCookies();
 }
 
+int QWebView::notificationInterval() const
+{
+    return m_notificationTimer.interval();
+}
+
+void QWebView::setNotificationInterval(int msecs)
+{
+    m_notificationTimer.setInterval(qMax(0, msecs));
+    if (msecs <= 0)
+        flushNotifications();
+}
+
+void QWebView::notify(PendingNotification notification, quint64 *dropped)
+{
+    // The getters already return the new value, only the signal is deferred
+    if (m_pendingNotifications & notification)
+        ++*dropped;
+    m_pendingNotifications |= notification;
+
+    if (m_notificationTimer.interval() <= 0)
+        flushNotifications();
+    else if (!m_notificationTimer.isActive())
+        m_notificationTimer.start();
+}
+
+void QWebView::flushNotifications()
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::flushNotifications");
+    m_notificationTimer.stop();
+    const int pending = m_pendingNotifications;
+    m_pendingNotifications = 0;
+
+    if (pending & UrlNotification)
+        Q_EMIT urlChanged();
+    if (pending & TitleNotification)
+        Q_EMIT titleChanged();
+    if (pending & LoadProgressNotification)
+        Q_EMIT loadProgressChanged();
+}
+
 void QWebView::onTitleChanged(const QString &title)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::onTitleChanged");
     if (m_title == title)
         return;
 
     m_title = title;
-    Q_EMIT titleChanged();
+    notify(TitleNotification, &m_droppedNotifications.titleChanged);
 }
 
 void QWebView::onUrlChanged(const QUrl &url)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::onUrlChanged");
     if (m_url == url)
         return;
 
     m_url = url;
-    Q_EMIT urlChanged();
+    notify(UrlNotification, &m_droppedNotifications.urlChanged);
 }
 
 void QWebView::onLoadProgressChanged(int progress)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::onLoadProgressChanged");
     if (m_progress == progress)
         return;
 
     m_progress = progress;
-    Q_EMIT loadProgressChanged();
+    notify(LoadProgressNotification, &m_droppedNotifications.loadProgressChanged);
 }
 
 void QWebView::onLoadingChanged(const QWebViewLoadRequestPrivate &loadRequest)
 {
+    Q_WEBVIEW_TRACE_NAVIGATION_SPAN("QWebView::onLoadingChanged", loadRequest.m_navigationId);
     if (loadRequest.m_status == QWebView::LoadFailedStatus)
         m_progress = 0;
 
     onUrlChanged(loadRequest.m_url);
+    // Listeners see the final URL and progress before the load state changes
+    flushNotifications();
     Q_EMIT loadingChanged(loadRequest);
 }
 
 void QWebView::onHttpUserAgentChanged(const QString &userAgent)
 {
+    Q_WEBVIEW_TRACE_SPAN("QWebView::onHttpUserAgentChanged");
     if (m_httpUserAgent == userAgent)
         return;
     m_httpUserAgent = userAgent;
     Q_EMIT httpUserAgentChanged();
 }
 
+void QWebView::onJavaScriptResult(int id, const QVariant &result)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebView::onJavaScriptResult");
+    const auto batch = m_javaScriptBatches.constFind(id);
+    if (batch == m_javaScriptBatches.constEnd()) {
+        Q_EMIT javaScriptResult(id, result);
+        return;
+    }
+
+    const int callbackId = batch.value().first;
+    const int count = batch.value().second;
+    m_javaScriptBatches.erase(batch);
+
+    QVariantList results;
+    QStringList errors;
+    results.reserve(count);
+    errors.reserve(count);
+    if (result.userType() == QMetaType::QVariantList) {
+        const QVariantList entries = result.toList();
+        for (const QVariant &entry : entries) {
+            const QVariantMap map = entry.toMap();
+            results.append(map.value(QStringLiteral("value")));
+            errors.append(map.value(QStringLiteral("error")).toString());
+        }
+    } else {
+        // The batch as a whole failed, the backend reports the reason as the result
+        const QString error = result.toString();
+        for (int i = 0; i < count; ++i) {
+            results.append(QVariant());
+            errors.append(error.isEmpty() ? QStringLiteral("Batch evaluation failed") : error);
+        }
+    }
+
+    Q_EMIT javaScriptBatchResult(callbackId, results, errors);
+}
+
 QWebViewSettings::QWebViewSettings(QAbstractWebViewSettings *settings)
     : d(settings)
 {
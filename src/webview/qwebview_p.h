@@ -17,7 +17,11 @@
 
 #include "qabstractwebview_p.h"
 #include "qwebviewinterface_p.h"
+#include <QtCore/qhash.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qtimer.h>
 #include <QtCore/qurl.h>
 #include <QtCore/qvariant.h>
 #include <QtGui/qimage.h>
@@ -29,6 +33,8 @@ class tst_QWebView;
 QT_BEGIN_NAMESPACE
 
 class QWebViewLoadRequestPrivate;
+class QWebViewRestoreQueue;
+class QWebChannelAbstractTransport;
 
 class QWindow;
 
@@ -66,6 +72,14 @@ private:
     QPointer<QAbstractWebViewSettings> d;
 };
 
+// Notifications that were folded into a later one instead of being emitted
+struct QWebViewNotificationStatistics
+{
+    quint64 titleChanged = 0;
+    quint64 urlChanged = 0;
+    quint64 loadProgressChanged = 0;
+};
+
 class Q_WEBVIEW_EXPORT QWebView
         : public QAbstractWebView
 {
@@ -75,10 +89,14 @@ public:
         LoadStartedStatus,
         LoadStoppedStatus,
         LoadSucceededStatus,
-        LoadFailedStatus
+        LoadFailedStatus,
+        LoadRedirectedStatus,
+        LoadCommittedStatus
     };
 
     explicit QWebView(QObject *p = nullptr);
+    // profile is backend specific, e.g. a QLinuxWebProfile, and must outlive the view
+    QWebView(QObject *profile, QObject *p);
     ~QWebView() override;
 
     QString httpUserAgent() const override;
@@ -93,6 +111,24 @@ public:
 
     QWebViewSettings *getSettings() const override;
     QWindow *nativeWindow() const override;
+    QWebChannelAbstractTransport *webChannelTransport() override;
+    bool setPageMetricsEnabled(bool enabled) override;
+    bool pageMetricsEnabled() const { return m_pageMetricsEnabled; }
+    void grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId) override;
+
+    // The state also carries the URL and title, which are restored right away,
+    // and the URL is loaded if the backend cannot restore its part. Restores are
+    // queued and run a few views at a time, QT_WEBVIEW_RESTORE_BATCH_SIZE views
+    // every QT_WEBVIEW_RESTORE_INTERVAL msecs. Navigating cancels a queued
+    // restore, reload() runs it right away.
+    QByteArray saveState() const override;
+    bool restoreState(const QByteArray &state) override;
+
+    // Title, URL and progress changes are delivered at most once per interval,
+    // with the latest value. 0 emits every change right away.
+    int notificationInterval() const;
+    void setNotificationInterval(int msecs);
+    QWebViewNotificationStatistics droppedNotifications() const { return m_droppedNotifications; }
 
     // NOTE: This is a temporary solution for WASM and should
     // be removed once window containers are supported.
@@ -104,17 +140,25 @@ public Q_SLOTS:
     void reload() override;
     void stop() override;
     void loadHtml(const QString &html, const QUrl &baseUrl = QUrl()) override;
+    void loadData(const QByteArray &data, const QString &mimeType = QStringLiteral("text/html"),
+                  const QString &encoding = QStringLiteral("utf-8"),
+                  const QUrl &baseUrl = QUrl()) override;
     void setCookie(const QString &domain, const QString &name,
                           const QString &value) override;
     void deleteCookie(const QString &domain, const QString &name) override;
     void deleteAllCookies() override;
 
+    // Runs all scripts in a single evaluation, results and errors arrive
+    // together in javaScriptBatchResult() in the order of the scripts.
+    void runJavaScriptBatch(const QStringList &scripts, int callbackId);
+
 Q_SIGNALS:
     void titleChanged();
     void urlChanged();
     void loadingChanged(const QWebViewLoadRequestPrivate &loadRequest);
     void loadProgressChanged();
     void javaScriptResult(int id, const QVariant &result);
+    void javaScriptBatchResult(int id, const QVariantList &results, const QStringList &errors);
     void httpUserAgentChanged();
     void cookieAdded(const QString &domain, const QString &name);
     void cookieRemoved(const QString &domain, const QString &name);
@@ -129,9 +173,22 @@ private Q_SLOTS:
     void onLoadProgressChanged(int progress);
     void onLoadingChanged(const QWebViewLoadRequestPrivate &loadRequest);
     void onHttpUserAgentChanged(const QString &httpUserAgent);
+    void onJavaScriptResult(int id, const QVariant &result);
+    void flushNotifications();
 
 private:
+    enum PendingNotification {
+        TitleNotification = 0x1,
+        UrlNotification = 0x2,
+        LoadProgressNotification = 0x4
+    };
+    void notify(PendingNotification notification, quint64 *dropped);
+    void applyState(const QUrl &url, const QByteArray &backendState);
+    void cancelRestore();
+    void applyPendingRestore();
+
     friend class QQuickWebView;
+    friend class QWebViewRestoreQueue;
     friend class ::tst_QWebView;
 
     QAbstractWebView *d = nullptr;
@@ -142,6 +199,19 @@ private:
     QString m_title;
     QUrl m_url;
     mutable QString m_httpUserAgent;
+
+    QTimer m_notificationTimer;
+    int m_pendingNotifications = 0;
+    QWebViewNotificationStatistics m_droppedNotifications;
+    bool m_pageMetricsEnabled = false;
+    // Queued by restoreState(), until QWebViewRestoreQueue runs it
+    quint64 m_pendingRestore = 0; // id, 0 if none
+    QUrl m_pendingRestoreUrl;
+    QByteArray m_pendingRestoreState;
+
+    // Batches use negative callback ids below -1, mapped to the caller's id and script count
+    QHash<int, QPair<int, int>> m_javaScriptBatches;
+    int m_nextJavaScriptBatchId = -2;
 };
 
 QT_END_NAMESPACE
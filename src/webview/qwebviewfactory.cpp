@@ -2,9 +2,23 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qwebviewfactory_p.h"
+#include "qwebviewfakebackend_p.h"
 #include "qwebviewplugin_p.h"
+#include "qwebviewtrace_p.h"
 #include <private/qfactoryloader_p.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qglobal.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qwaitcondition.h>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+#include <QtCore/qcbormap.h>
+#else
+#include <QtCore/qjsonobject.h>
+#endif
 
 #ifdef Q_OS_WIN
 #include "qwebview2webviewplugin.h"
@@ -75,7 +89,256 @@ private:
     QNullWebViewSettings *m_settings = nullptr;
 };
 
+namespace {
+struct QWebViewBackend
+{
+    QString name;
+    QStringList keys;
+    QStringList capabilities;
+    bool requiresInit = false;
+    // Never picked as the default, only when requested by name
+    bool explicitOnly = false;
+    QWebViewPlugin *(*createBuiltin)() = nullptr;
+    int loaderIndex = -1;
+    QWebViewPlugin *plugin = nullptr;
+    bool loaded = false;
+    QThread *preparingThread = nullptr; // set while prepare() runs unlocked
+};
+
+// Backends are only described here, a backend's plugin object is created (and
+// its module loaded, for dynamic plugins) the first time a view needs it.
+class QWebViewBackendRegistry
+{
+public:
+    QWebViewBackendRegistry();
+    ~QWebViewBackendRegistry();
+
+    QStringList names();
+    QWebViewBackend *find(const QString &name);
+    QWebViewBackend *selected();
+    // Called with mutex held, which is released while the plugin prepares
+    QWebViewPlugin *plugin(QWebViewBackend *backend);
+
+    QMutex mutex;
+
+private:
+    void addBuiltin(const QString &name, const QStringList &capabilities,
+                    QWebViewPlugin *(*create)(), bool requiresInit = false);
+    QWebViewBackend *findBuiltin(const QString &name) const;
+    QWebViewBackend *firstDefault() const;
+    void scanPlugins();
+
+    QList<QWebViewBackend *> m_backends;
+    QWaitCondition m_prepared;
+    QScopedPointer<QFactoryLoader> m_loader;
+    QWebViewBackend *m_selected = nullptr;
+    bool m_selectionResolved = false;
+    bool m_pluginsScanned = false;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(QWebViewBackendRegistry, backendRegistry)
+
+QWebViewBackendRegistry::QWebViewBackendRegistry()
+{
+#ifdef Q_OS_WIN
+    addBuiltin(QStringLiteral("webview2"), { QStringLiteral("webview") },
+               []() -> QWebViewPlugin * { return new QWebView2WebViewPlugin; });
+#endif
+#ifdef Q_OS_MACOS
+    addBuiltin(QStringLiteral("darwin"), { QStringLiteral("webview") },
+               []() -> QWebViewPlugin * { return new QDarwinWebViewPlugin; });
+#endif
+#ifdef Q_OS_LINUX
+    // Prewarming needs the plugin prepared at startup
+    addBuiltin(QStringLiteral("linux"),
+               { QStringLiteral("webview"), QStringLiteral("offscreen-webview") },
+               []() -> QWebViewPlugin * { return new QLinuxWebViewPlugin; },
+               QLinuxWebViewPlugin::contextOptions().prewarm);
+#endif
+
+    // Scripted backend without engine or display, see QFakeWebView
+    QWebViewBackend *fake = new QWebViewBackend;
+    fake->name = QStringLiteral("fake");
+    fake->keys = QStringList{ fake->name };
+    fake->capabilities = QStringList{ QStringLiteral("webview"),
+                                      QStringLiteral("offscreen-webview") };
+    fake->explicitOnly = true;
+    fake->createBuiltin = []() -> QWebViewPlugin * { return new QFakeWebViewPlugin; };
+    m_backends.append(fake);
+}
+
+QWebViewBackendRegistry::~QWebViewBackendRegistry()
+{
+    for (QWebViewBackend *backend : m_backends) {
+        // Plugins from the factory loader are owned by the loader
+        if (backend->createBuiltin)
+            delete backend->plugin;
+        delete backend;
+    }
+}
+
+void QWebViewBackendRegistry::addBuiltin(const QString &name, const QStringList &capabilities,
+                                         QWebViewPlugin *(*create)(), bool requiresInit)
+{
+    QWebViewBackend *backend = new QWebViewBackend;
+    backend->name = name;
+    // Built-in backends also answer to "native", like the default plugin upstream
+    backend->keys = QStringList{ name, QStringLiteral("native") };
+    backend->capabilities = capabilities;
+    backend->createBuiltin = create;
+    backend->requiresInit = requiresInit;
+    m_backends.append(backend);
+}
+
+QWebViewBackend *QWebViewBackendRegistry::findBuiltin(const QString &name) const
+{
+    for (QWebViewBackend *backend : m_backends) {
+        if (backend->createBuiltin && backend->keys.contains(name))
+            return backend;
+    }
+    return nullptr;
+}
+
+QWebViewBackend *QWebViewBackendRegistry::firstDefault() const
+{
+    for (QWebViewBackend *backend : m_backends) {
+        if (!backend->explicitOnly)
+            return backend;
+    }
+    return nullptr;
+}
+
+void QWebViewBackendRegistry::scanPlugins()
+{
+    if (m_pluginsScanned)
+        return;
+    m_pluginsScanned = true;
+
+    // Only reads the plugin metadata, the libraries are loaded by plugin()
+    m_loader.reset(new QFactoryLoader(QWebViewPluginInterface_iid, QLatin1String("/webview")));
+    const QMultiMap<int, QString> keyMap = m_loader->keyMap();
+    const QList<int> indexes = keyMap.uniqueKeys();
+    for (int index : indexes) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+        const QVariantMap metaData = m_loader->metaData()
+                                             .at(index)
+                                             .value(QtPluginMetaDataKeys::MetaData)
+                                             .toMap()
+                                             .toVariantMap();
+#else
+        const QVariantMap metaData = m_loader->metaData()
+                                             .at(index)
+                                             .value(QLatin1String("MetaData"))
+                                             .toObject()
+                                             .toVariantMap();
+#endif
+        QWebViewBackend *backend = new QWebViewBackend;
+        backend->keys = keyMap.values(index);
+        backend->name = backend->keys.constFirst();
+        backend->capabilities = metaData.value(QStringLiteral("Capabilities")).toStringList();
+        if (backend->capabilities.isEmpty())
+            backend->capabilities.append(QStringLiteral("webview"));
+        backend->requiresInit = metaData.value(QStringLiteral("RequiresInit")).toBool();
+        backend->loaderIndex = index;
+        m_backends.append(backend);
+    }
+}
+
+QStringList QWebViewBackendRegistry::names()
+{
+    scanPlugins();
+    QStringList names;
+    for (const QWebViewBackend *backend : m_backends)
+        names.append(backend->name);
+    return names;
+}
+
+QWebViewBackend *QWebViewBackendRegistry::find(const QString &name)
+{
+    if (QWebViewBackend *backend = findBuiltin(name))
+        return backend;
+
+    scanPlugins();
+    for (QWebViewBackend *backend : m_backends) {
+        if (backend->keys.contains(name))
+            return backend;
+    }
+    return nullptr;
+}
+
+QWebViewBackend *QWebViewBackendRegistry::selected()
+{
+    if (m_selectionResolved)
+        return m_selected;
+    m_selectionResolved = true;
+
+    const QString requested = qEnvironmentVariable("QT_WEBVIEW_PLUGIN");
+    if (!requested.isEmpty()) {
+        m_selected = find(requested);
+        if (!m_selected)
+            qWarning("QT_WEBVIEW_PLUGIN: WebView backend \"%s\" not found, using the default.",
+                     qPrintable(requested));
+    }
+
+    if (!m_selected)
+        m_selected = firstDefault();
+
+    // No built-in backend for this platform, fall back to whatever is installed
+    if (!m_selected) {
+        scanPlugins();
+        m_selected = firstDefault();
+    }
+
+    return m_selected;
+}
+
+QWebViewPlugin *QWebViewBackendRegistry::plugin(QWebViewBackend *backend)
+{
+    // Other threads wait for prepare(), the preparing thread may use the plugin already
+    while (backend->preparingThread && backend->preparingThread != QThread::currentThread())
+        m_prepared.wait(&mutex);
+    if (backend->loaded)
+        return backend->plugin;
+    backend->loaded = true;
+
+    if (backend->createBuiltin)
+        backend->plugin = backend->createBuiltin();
+    else if (m_loader)
+        backend->plugin = qobject_cast<QWebViewPlugin *>(m_loader->instance(backend->loaderIndex));
+
+    if (backend->plugin) {
+        // prepare() may call into the factory, which takes the lock again
+        backend->preparingThread = QThread::currentThread();
+        mutex.unlock();
+        backend->plugin->prepare();
+        mutex.lock();
+        backend->preparingThread = nullptr;
+        m_prepared.wakeAll();
+    } else {
+        qWarning("Failed to load WebView backend \"%s\".", qPrintable(backend->name));
+    }
+
+    return backend->plugin;
+}
+
 QAbstractWebView *QWebViewFactory::createWebView(QObject *parent)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebViewFactory::createWebView");
+    const qint64 requestedAt = QDeadlineTimer::current().deadline();
+    QWebViewPool *pool = QWebViewPool::instance();
+    if (!pool)
+        return createUnpooledWebView(parent);
+
+    QAbstractWebView *wv = pool->take(parent);
+    const bool pooled = wv != nullptr;
+    if (!wv)
+        wv = createUnpooledWebView(parent);
+    pool->trackFirstLoad(wv, requestedAt, pooled);
+    return wv;
+}
+
+QAbstractWebView *QWebViewFactory::createUnpooledWebView(QObject *parent)
 {
     QAbstractWebView *wv = nullptr;
     QWebViewPlugin *plugin = getPlugin();
@@ -90,28 +353,117 @@ QAbstractWebView *QWebViewFactory::createWebView(QObject *parent)
     return wv;
 }
 
+QAbstractWebView *QWebViewFactory::createWebView(QObject *profile, QObject *parent)
+{
+    Q_WEBVIEW_TRACE_SPAN("QWebViewFactory::createWebView");
+    if (!profile)
+        return createWebView(parent);
+
+    QAbstractWebView *wv = nullptr;
+    QWebViewPlugin *plugin = getPlugin();
+    if (plugin)
+        wv = plugin->create(QStringLiteral("webview"), profile, parent);
+
+    if (!wv || !plugin) {
+        qWarning("No WebView plug-in found!");
+        wv = new QNullWebView(parent);
+    }
+
+    return wv;
+}
+
+QAbstractWebView *QWebViewFactory::createOffscreenWebView(QObject *parent)
+{
+    const QString key = QStringLiteral("offscreen-webview");
+    QWebViewPlugin *plugin = hasCapability(key) ? getPlugin() : nullptr;
+    QAbstractWebView *wv = plugin ? plugin->create(key, parent) : nullptr;
+    return wv ? wv : createUnpooledWebView(parent);
+}
+
+bool QWebViewFactory::recycleWebView(QAbstractWebView *webView)
+{
+    QWebViewPool *pool = QWebViewPool::instance();
+    return pool && pool->recycle(webView);
+}
+
+int QWebViewFactory::poolSize()
+{
+    QWebViewPool *pool = QWebViewPool::instance();
+    return pool ? pool->size() : 0;
+}
+
+void QWebViewFactory::setPoolSize(int size)
+{
+    if (QWebViewPool *pool = QWebViewPool::instance())
+        pool->setSize(size);
+    else
+        qWarning("QWebViewFactory::setPoolSize() requires a QCoreApplication instance");
+}
+
+QWebViewPoolStatistics QWebViewFactory::poolStatistics()
+{
+    QWebViewPool *pool = QWebViewPool::instance();
+    return pool ? pool->statistics() : QWebViewPoolStatistics();
+}
+
+void QWebViewFactory::resetPoolStatistics()
+{
+    if (QWebViewPool *pool = QWebViewPool::instance())
+        pool->resetStatistics();
+}
+
 bool QWebViewFactory::requiresExtraInitializationSteps()
 {
-    return true;
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QWebViewBackend *backend = registry->selected();
+    return backend && backend->requiresInit;
 }
 
 QWebViewPlugin *QWebViewFactory::getPlugin()
 {
-#ifdef Q_OS_WIN
-    return new QWebView2WebViewPlugin;
-#endif
-#ifdef Q_OS_MACOS
-    return new QDarwinWebViewPlugin;
-#endif
-#ifdef Q_OS_LINUX
-    return new QLinuxWebViewPlugin;
-#endif
-    return nullptr;
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QWebViewBackend *backend = registry->selected();
+    return backend ? registry->plugin(backend) : nullptr;
+}
+
+QString QWebViewFactory::backendName()
+{
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QWebViewBackend *backend = registry->selected();
+    return backend ? backend->name : QString();
+}
+
+QStringList QWebViewFactory::availableBackends()
+{
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    return registry->names();
+}
+
+QStringList QWebViewFactory::backendCapabilities(const QString &backendName)
+{
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QWebViewBackend *backend =
+            backendName.isEmpty() ? registry->selected() : registry->find(backendName);
+    return backend ? backend->capabilities : QStringList();
+}
+
+bool QWebViewFactory::hasCapability(const QString &capability, const QString &backendName)
+{
+    return backendCapabilities(backendName).contains(capability);
 }
 
 bool QWebViewFactory::loadedPluginHasKey(const QString key)
 {
-    return true;
+    QWebViewBackendRegistry *registry = backendRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QWebViewBackend *backend = registry->selected();
+    // Built-in backends advertise what they create as capabilities only
+    return backend && (backend->keys.contains(key) || backend->capabilities.contains(key));
 }
 
 QT_END_NAMESPACE
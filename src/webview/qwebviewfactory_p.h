@@ -16,6 +16,9 @@
 //
 
 #include "qabstractwebview_p.h"
+#include "qwebviewpool_p.h"
+
+#include <QtCore/qstringlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -25,8 +28,26 @@ namespace QWebViewFactory
 {
     QWebViewPlugin *getPlugin();
     QAbstractWebView *createWebView(QObject *parent = nullptr);
+    QAbstractWebView *createUnpooledWebView(QObject *parent = nullptr);
+    // Views with a profile are never taken from or returned to the pool
+    QAbstractWebView *createWebView(QObject *profile, QObject *parent);
+    // Uses the "offscreen-webview" key when the backend has it, a regular view otherwise
+    QAbstractWebView *createOffscreenWebView(QObject *parent = nullptr);
+    bool recycleWebView(QAbstractWebView *webView);
     bool requiresExtraInitializationSteps();
     Q_WEBVIEW_EXPORT bool loadedPluginHasKey(const QString key);
+
+    // The backend is chosen with QT_WEBVIEW_PLUGIN, otherwise the built-in one is used
+    Q_WEBVIEW_EXPORT QString backendName();
+    Q_WEBVIEW_EXPORT QStringList availableBackends();
+    Q_WEBVIEW_EXPORT QStringList backendCapabilities(const QString &backendName = QString());
+    Q_WEBVIEW_EXPORT bool hasCapability(const QString &capability,
+                                        const QString &backendName = QString());
+
+    Q_WEBVIEW_EXPORT int poolSize();
+    Q_WEBVIEW_EXPORT void setPoolSize(int size);
+    Q_WEBVIEW_EXPORT QWebViewPoolStatistics poolStatistics();
+    Q_WEBVIEW_EXPORT void resetPoolStatistics();
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,461 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qwebviewfakebackend_p.h"
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qregularexpression.h>
+#include <QtGui/qimage.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct FakeDefaults
+{
+    FakeDefaults();
+
+    QMutex mutex;
+    QFakeWebViewTimeline timeline;
+    QFakeWebView::JavaScriptHandler javaScriptHandler;
+};
+
+// Roughly what an engine reports for a small page, all within a few msecs
+QFakeWebViewTimeline builtinTimeline()
+{
+    return {
+        { QFakeWebViewEvent::LoadStarted, 0, QVariant() },
+        { QFakeWebViewEvent::Url, 0, QVariant() },
+        { QFakeWebViewEvent::Progress, 0, 10 },
+        { QFakeWebViewEvent::LoadCommitted, 1, 200 },
+        { QFakeWebViewEvent::Progress, 1, 100 },
+        { QFakeWebViewEvent::Title, 0, QVariant() },
+        { QFakeWebViewEvent::LoadSucceeded, 0, QVariant() },
+    };
+}
+
+FakeDefaults::FakeDefaults() : timeline(builtinTimeline())
+{
+    const QString fileName = qEnvironmentVariable("QT_WEBVIEW_FAKE_TIMELINE");
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("QT_WEBVIEW_FAKE_TIMELINE: cannot open \"%s\": %s", qPrintable(fileName),
+                 qPrintable(file.errorString()));
+        return;
+    }
+    QString errorString;
+    const QFakeWebViewTimeline fromFile =
+            QFakeWebView::timelineFromJson(file.readAll(), &errorString);
+    if (!errorString.isEmpty())
+        qWarning("QT_WEBVIEW_FAKE_TIMELINE: \"%s\": %s", qPrintable(fileName),
+                 qPrintable(errorString));
+    else
+        timeline = fromFile;
+}
+
+const char *const eventTypeNames[] = {
+    "load-started", "load-redirected", "load-committed", "load-succeeded",
+    "load-failed",  "load-stopped",    "progress",       "title",
+    "url",          "cookie-added",    "cookie-removed",
+};
+} // namespace
+
+Q_GLOBAL_STATIC(FakeDefaults, fakeDefaults)
+
+static quint64 lastNavigationId = 0;
+
+static QString defaultUserAgent()
+{
+    return QStringLiteral("Mozilla/5.0 QtWebView/" QT_VERSION_STR " (fake)");
+}
+
+QFakeWebView::QFakeWebView(QObject *parent)
+    : QAbstractWebView(parent),
+      m_settings(new QFakeWebViewSettings(this)),
+      m_httpUserAgent(defaultUserAgent())
+{
+    {
+        QMutexLocker locker(&fakeDefaults->mutex);
+        m_timeline = fakeDefaults->timeline;
+        m_javaScriptHandler = fakeDefaults->javaScriptHandler;
+    }
+
+    m_replayTimer.setSingleShot(true);
+    connect(&m_replayTimer, &QTimer::timeout, this, &QFakeWebView::replay);
+}
+
+QFakeWebView::~QFakeWebView() = default;
+
+QFakeWebViewTimeline QFakeWebView::defaultTimeline()
+{
+    QMutexLocker locker(&fakeDefaults->mutex);
+    return fakeDefaults->timeline;
+}
+
+void QFakeWebView::setDefaultTimeline(const QFakeWebViewTimeline &timeline)
+{
+    QMutexLocker locker(&fakeDefaults->mutex);
+    fakeDefaults->timeline = timeline;
+}
+
+void QFakeWebView::setDefaultJavaScriptHandler(const JavaScriptHandler &handler)
+{
+    QMutexLocker locker(&fakeDefaults->mutex);
+    fakeDefaults->javaScriptHandler = handler;
+}
+
+QFakeWebViewTimeline QFakeWebView::timelineFromJson(const QByteArray &json, QString *errorString)
+{
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isArray()) {
+        if (errorString)
+            *errorString = parseError.error != QJsonParseError::NoError
+                    ? parseError.errorString()
+                    : QStringLiteral("Expected an array of events");
+        return QFakeWebViewTimeline();
+    }
+
+    QFakeWebViewTimeline timeline;
+    const QJsonArray events = document.array();
+    for (int i = 0; i < events.size(); ++i) {
+        const QJsonObject object = events.at(i).toObject();
+        const QString typeName = object.value(QStringLiteral("type")).toString();
+        int type = 0;
+        const int typeCount = int(sizeof(eventTypeNames) / sizeof(eventTypeNames[0]));
+        while (type < typeCount && typeName != QLatin1String(eventTypeNames[type]))
+            ++type;
+        if (type == typeCount) {
+            if (errorString)
+                *errorString = QStringLiteral("Unknown event type \"%1\" at index %2")
+                                       .arg(typeName)
+                                       .arg(i);
+            return QFakeWebViewTimeline();
+        }
+
+        QFakeWebViewEvent event;
+        event.type = QFakeWebViewEvent::Type(type);
+        event.delay = qMax(0, object.value(QStringLiteral("delay")).toInt());
+        event.value = object.value(QStringLiteral("value")).toVariant();
+        timeline.append(event);
+    }
+    return timeline;
+}
+
+void QFakeWebView::setHttpUserAgent(const QString &userAgent)
+{
+    if (m_httpUserAgent == userAgent)
+        return;
+    m_httpUserAgent = userAgent;
+    emit httpUserAgentChanged(userAgent);
+}
+
+void QFakeWebView::setUrl(const QUrl &url)
+{
+    // Drop the forward history, like a navigation in a browser
+    m_history.erase(m_history.begin() + m_historyIndex + 1, m_history.end());
+    m_history.append(qMakePair(url, url.toString()));
+    m_historyIndex = m_history.size() - 1;
+    navigate(url, url.toString());
+}
+
+void QFakeWebView::goBack()
+{
+    if (!canGoBack())
+        return;
+    --m_historyIndex;
+    navigate(m_history.at(m_historyIndex).first, m_history.at(m_historyIndex).second);
+}
+
+void QFakeWebView::goForward()
+{
+    if (!canGoForward())
+        return;
+    ++m_historyIndex;
+    navigate(m_history.at(m_historyIndex).first, m_history.at(m_historyIndex).second);
+}
+
+void QFakeWebView::stop()
+{
+    m_replayTimer.stop();
+    m_replay.clear();
+    m_replayPosition = 0;
+    if (m_loading) {
+        m_loading = false;
+        m_navigation.m_finishedAt = QDeadlineTimer::current().deadlineNSecs();
+        emitLoadingChanged(QWebView::LoadStoppedStatus);
+    }
+}
+
+void QFakeWebView::reload()
+{
+    if (m_historyIndex >= 0)
+        navigate(m_history.at(m_historyIndex).first, m_history.at(m_historyIndex).second);
+}
+
+void QFakeWebView::loadHtml(const QString &html, const QUrl &baseUrl)
+{
+    static const QRegularExpression titleExpression(
+            QStringLiteral("<title[^>]*>(.*)</title>"),
+            QRegularExpression::CaseInsensitiveOption
+                    | QRegularExpression::DotMatchesEverythingOption
+                    | QRegularExpression::InvertedGreedinessOption);
+    const QRegularExpressionMatch match = titleExpression.match(html);
+    const QString pageTitle = match.hasMatch() ? match.captured(1).trimmed() : baseUrl.toString();
+
+    m_history.erase(m_history.begin() + m_historyIndex + 1, m_history.end());
+    m_history.append(qMakePair(baseUrl, pageTitle));
+    m_historyIndex = m_history.size() - 1;
+    navigate(baseUrl, pageTitle);
+}
+
+void QFakeWebView::runJavaScriptPrivate(const QString &script, int callbackId)
+{
+    if (callbackId == -1 && !m_javaScriptHandler)
+        return;
+
+    // Answered asynchronously, as real engines do
+    const quint64 generation = m_generation;
+    QTimer::singleShot(m_javaScriptDelay, this, [this, generation, script, callbackId]() {
+        if (generation != m_generation)
+            return;
+        const QVariant result = m_javaScriptHandler && m_settings->javaScriptEnabled()
+                ? m_javaScriptHandler(script)
+                : QVariant();
+        if (callbackId != -1)
+            emit javaScriptResult(callbackId, result);
+    });
+}
+
+void QFakeWebView::setCookie(const QString &domain, const QString &name, const QString &value)
+{
+    m_cookies.insert(qMakePair(domain, name), value);
+    const quint64 generation = m_generation;
+    QMetaObject::invokeMethod(
+            this,
+            [this, generation, domain, name]() {
+                if (generation == m_generation)
+                    emit cookieAdded(domain, name);
+            },
+            Qt::QueuedConnection);
+}
+
+void QFakeWebView::deleteCookie(const QString &domain, const QString &name)
+{
+    if (!m_cookies.remove(qMakePair(domain, name)))
+        return;
+    const quint64 generation = m_generation;
+    QMetaObject::invokeMethod(
+            this,
+            [this, generation, domain, name]() {
+                if (generation == m_generation)
+                    emit cookieRemoved(domain, name);
+            },
+            Qt::QueuedConnection);
+}
+
+void QFakeWebView::deleteAllCookies()
+{
+    const QList<QPair<QString, QString>> cookies = m_cookies.keys();
+    m_cookies.clear();
+    const quint64 generation = m_generation;
+    QMetaObject::invokeMethod(
+            this,
+            [this, generation, cookies]() {
+                if (generation != m_generation)
+                    return;
+                for (const QPair<QString, QString> &cookie : cookies)
+                    emit cookieRemoved(cookie.first, cookie.second);
+            },
+            Qt::QueuedConnection);
+}
+
+bool QFakeWebView::reset()
+{
+    ++m_generation;
+    m_replayTimer.stop();
+    m_replay.clear();
+    m_replayPosition = 0;
+    m_navigation = QWebViewLoadRequestPrivate();
+    m_loadUrl.clear();
+    m_loadTitle.clear();
+    m_history.clear();
+    m_historyIndex = -1;
+    m_url.clear();
+    m_title.clear();
+    m_loadProgress = 0;
+    m_loading = false;
+    m_cookies.clear();
+    m_settings->setJavaScriptEnabled(true);
+    m_settings->setAllowFileAccess(false);
+    setHttpUserAgent(defaultUserAgent());
+    return true;
+}
+
+QByteArray QFakeWebView::saveState() const
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << qint32(m_historyIndex) << m_history;
+    return state;
+}
+
+bool QFakeWebView::restoreState(const QByteArray &state)
+{
+    QDataStream stream(state);
+    qint32 index = -1;
+    QList<QPair<QUrl, QString>> history;
+    stream >> index >> history;
+    if (stream.status() != QDataStream::Ok || index < 0 || index >= history.size())
+        return false;
+
+    m_history = history;
+    m_historyIndex = index;
+    navigate(m_history.at(m_historyIndex).first, m_history.at(m_historyIndex).second);
+    return true;
+}
+
+void QFakeWebView::grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId)
+{
+    Q_UNUSED(region);
+    // A blank page, so that snapshot pipelines can run without a display
+    QImage image(targetSize.isValid() ? targetSize : QSize(800, 600), QImage::Format_RGB32);
+    image.fill(Qt::white);
+    const quint64 generation = m_generation;
+    QMetaObject::invokeMethod(
+            this,
+            [this, generation, callbackId, image]() {
+                if (generation == m_generation)
+                    emit snapshotReady(callbackId, image);
+            },
+            Qt::QueuedConnection);
+}
+
+void QFakeWebView::navigate(const QUrl &url, const QString &pageTitle)
+{
+    if (m_loading) {
+        m_navigation.m_finishedAt = QDeadlineTimer::current().deadlineNSecs();
+        m_loading = false;
+        emitLoadingChanged(QWebView::LoadStoppedStatus);
+    }
+
+    m_loadUrl = url;
+    m_loadTitle = pageTitle;
+    m_navigation = QWebViewLoadRequestPrivate();
+    m_navigation.m_navigationId = ++lastNavigationId;
+    m_replay = m_timeline;
+    m_replayPosition = 0;
+    // Even the first event is delivered from the event loop
+    if (m_replay.isEmpty())
+        m_replayTimer.stop();
+    else
+        m_replayTimer.start(m_replay.constFirst().delay);
+}
+
+void QFakeWebView::replay()
+{
+    const quint64 navigationId = m_navigation.m_navigationId;
+    while (m_replayPosition < m_replay.size()) {
+        apply(m_replay.at(m_replayPosition++));
+        // A receiver may have started another load or stopped this one
+        if (m_navigation.m_navigationId != navigationId || m_replayPosition >= m_replay.size())
+            return;
+        const int delay = m_replay.at(m_replayPosition).delay;
+        if (delay > 0) {
+            m_replayTimer.start(delay);
+            return;
+        }
+    }
+}
+
+void QFakeWebView::apply(const QFakeWebViewEvent &event)
+{
+    const qint64 now = QDeadlineTimer::current().deadlineNSecs();
+    switch (event.type) {
+    case QFakeWebViewEvent::LoadStarted:
+        m_loading = true;
+        m_navigation.m_startedAt = now;
+        emitLoadingChanged(QWebView::LoadStartedStatus);
+        break;
+    case QFakeWebViewEvent::LoadRedirected:
+        if (!event.value.isNull())
+            m_loadUrl = QUrl(event.value.toString());
+        m_navigation.m_redirectedAt = now;
+        emitLoadingChanged(QWebView::LoadRedirectedStatus);
+        break;
+    case QFakeWebViewEvent::LoadCommitted:
+        m_navigation.m_committedAt = now;
+        m_navigation.m_httpStatusCode = event.value.toInt();
+        emitLoadingChanged(QWebView::LoadCommittedStatus);
+        break;
+    case QFakeWebViewEvent::LoadSucceeded:
+    case QFakeWebViewEvent::LoadFailed:
+    case QFakeWebViewEvent::LoadStopped:
+        m_loading = false;
+        m_navigation.m_finishedAt = now;
+        if (event.type == QFakeWebViewEvent::LoadSucceeded)
+            emitLoadingChanged(QWebView::LoadSucceededStatus);
+        else if (event.type == QFakeWebViewEvent::LoadStopped)
+            emitLoadingChanged(QWebView::LoadStoppedStatus);
+        else
+            emitLoadingChanged(QWebView::LoadFailedStatus,
+                               event.value.isNull() ? QStringLiteral("Load failed")
+                                                    : event.value.toString());
+        break;
+    case QFakeWebViewEvent::Progress:
+        m_loadProgress = qBound(0, event.value.toInt(), 100);
+        emit loadProgressChanged(m_loadProgress);
+        break;
+    case QFakeWebViewEvent::Title:
+        m_title = event.value.isNull() ? m_loadTitle : event.value.toString();
+        emit titleChanged(m_title);
+        break;
+    case QFakeWebViewEvent::Url:
+        m_url = event.value.isNull() ? m_loadUrl : QUrl(event.value.toString());
+        emit urlChanged(m_url);
+        break;
+    case QFakeWebViewEvent::CookieAdded:
+    case QFakeWebViewEvent::CookieRemoved: {
+        const QStringList cookie = event.value.toStringList();
+        if (cookie.size() < 2) {
+            qWarning("QFakeWebView: cookie events need a [domain, name] value");
+            break;
+        }
+        const QPair<QString, QString> key = qMakePair(cookie.at(0), cookie.at(1));
+        if (event.type == QFakeWebViewEvent::CookieAdded) {
+            m_cookies.insert(key, cookie.value(2));
+            emit cookieAdded(key.first, key.second);
+        } else if (m_cookies.remove(key)) {
+            emit cookieRemoved(key.first, key.second);
+        }
+        break;
+    }
+    }
+}
+
+void QFakeWebView::emitLoadingChanged(QWebView::LoadStatus status, const QString &errorString)
+{
+    QWebViewLoadRequestPrivate request = m_navigation;
+    request.m_url = m_loadUrl;
+    request.m_status = status;
+    request.m_errorString = errorString;
+    emit loadingChanged(request);
+}
+
+QAbstractWebView *QFakeWebViewPlugin::create(const QString &key, QObject *parent) const
+{
+    if (key == QStringLiteral("webview") || key == QStringLiteral("offscreen-webview"))
+        return new QFakeWebView(parent);
+    return nullptr;
+}
+
+QT_END_NAMESPACE
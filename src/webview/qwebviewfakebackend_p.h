@@ -0,0 +1,177 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QWEBVIEWFAKEBACKEND_P_H
+#define QWEBVIEWFAKEBACKEND_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qabstractwebview_p.h"
+#include "qwebviewloadrequest_p.h"
+#include "qwebviewplugin_p.h"
+
+#include <QtCore/qlist.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qvariant.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+struct Q_WEBVIEW_EXPORT QFakeWebViewEvent
+{
+    enum Type {
+        LoadStarted,
+        LoadRedirected, // value: URL redirected to
+        LoadCommitted, // value: HTTP status code
+        LoadSucceeded,
+        LoadFailed, // value: error string
+        LoadStopped,
+        Progress, // value: 0 to 100
+        Title, // value: title, the <title> of the loaded HTML or the URL if null
+        Url, // value: URL, the loaded one if null
+        CookieAdded, // value: [domain, name]
+        CookieRemoved // value: [domain, name]
+    };
+
+    Type type = LoadStarted;
+    int delay = 0; // msecs after the previous event
+    QVariant value;
+};
+
+using QFakeWebViewTimeline = QList<QFakeWebViewEvent>;
+
+class QFakeWebViewSettings : public QAbstractWebViewSettings
+{
+    Q_OBJECT
+public:
+    explicit QFakeWebViewSettings(QObject *p = nullptr) : QAbstractWebViewSettings(p) { }
+
+    bool localStorageEnabled() const override { return m_localStorageEnabled; }
+    bool javaScriptEnabled() const override { return m_javaScriptEnabled; }
+    bool localContentCanAccessFileUrls() const override { return m_localContentCanAccessFileUrls; }
+    bool allowFileAccess() const override { return m_allowFileAccess; }
+    void setLocalContentCanAccessFileUrls(bool enabled) override
+    {
+        m_localContentCanAccessFileUrls = enabled;
+    }
+    void setJavaScriptEnabled(bool enabled) override { m_javaScriptEnabled = enabled; }
+    void setLocalStorageEnabled(bool enabled) override { m_localStorageEnabled = enabled; }
+    void setAllowFileAccess(bool enabled) override { m_allowFileAccess = enabled; }
+
+private:
+    bool m_localStorageEnabled = true;
+    bool m_javaScriptEnabled = true;
+    bool m_localContentCanAccessFileUrls = false;
+    bool m_allowFileAccess = false;
+};
+
+// Backend without an engine or a display. Every load replays a scripted
+// timeline of events, JavaScript is answered by a handler and cookies are
+// kept in memory. Selected with QT_WEBVIEW_PLUGIN=fake, it measures and
+// tests QWebView without the noise of a real engine.
+class Q_WEBVIEW_EXPORT QFakeWebView : public QAbstractWebView
+{
+    Q_OBJECT
+public:
+    using JavaScriptHandler = std::function<QVariant(const QString &script)>;
+
+    explicit QFakeWebView(QObject *parent = nullptr);
+    ~QFakeWebView() override;
+
+    // Replayed on every load. Views start with the default timeline, which
+    // is read from the JSON file in QT_WEBVIEW_FAKE_TIMELINE if set.
+    QFakeWebViewTimeline timeline() const { return m_timeline; }
+    void setTimeline(const QFakeWebViewTimeline &timeline) { m_timeline = timeline; }
+    static QFakeWebViewTimeline defaultTimeline();
+    static void setDefaultTimeline(const QFakeWebViewTimeline &timeline);
+
+    // Results are null without a handler
+    void setJavaScriptHandler(const JavaScriptHandler &handler) { m_javaScriptHandler = handler; }
+    static void setDefaultJavaScriptHandler(const JavaScriptHandler &handler);
+    int javaScriptDelay() const { return m_javaScriptDelay; }
+    void setJavaScriptDelay(int msecs) { m_javaScriptDelay = qMax(0, msecs); }
+
+    // [{ "type": "progress", "delay": 10, "value": 50 }, ...], type names as in
+    // QFakeWebViewEvent::Type in lower case and with dashes: "load-started"
+    static QFakeWebViewTimeline timelineFromJson(const QByteArray &json,
+                                                 QString *errorString = nullptr);
+
+    QString httpUserAgent() const override { return m_httpUserAgent; }
+    void setHttpUserAgent(const QString &userAgent) override;
+    void setUrl(const QUrl &url) override;
+    bool canGoBack() const override { return m_historyIndex > 0; }
+    bool canGoForward() const override { return m_historyIndex < m_history.size() - 1; }
+    QString title() const override { return m_title; }
+    int loadProgress() const override { return m_loadProgress; }
+    bool isLoading() const override { return m_loading; }
+    void goBack() override;
+    void goForward() override;
+    void stop() override;
+    void reload() override;
+    void loadHtml(const QString &html, const QUrl &baseUrl) override;
+    void runJavaScriptPrivate(const QString &script, int callbackId) override;
+    void setCookie(const QString &domain, const QString &name, const QString &value) override;
+    void deleteCookie(const QString &domain, const QString &name) override;
+    void deleteAllCookies() override;
+    QWindow *nativeWindow() const override { return nullptr; }
+    bool reset() override;
+    // The history and its position, restoring replays the current entry
+    QByteArray saveState() const override;
+    bool restoreState(const QByteArray &state) override;
+    void grabSnapshot(SnapshotRegion region, const QSize &targetSize, int callbackId) override;
+
+protected:
+    QAbstractWebViewSettings *getSettings() const override { return m_settings; }
+
+private:
+    void navigate(const QUrl &url, const QString &pageTitle);
+    void replay();
+    void apply(const QFakeWebViewEvent &event);
+    void emitLoadingChanged(QWebView::LoadStatus status, const QString &errorString = QString());
+
+    QFakeWebViewSettings *m_settings;
+    QFakeWebViewTimeline m_timeline;
+    JavaScriptHandler m_javaScriptHandler;
+    int m_javaScriptDelay = 0;
+
+    QTimer m_replayTimer;
+    QFakeWebViewTimeline m_replay; // copy of the timeline of the current load
+    int m_replayPosition = 0;
+    QUrl m_loadUrl;
+    QString m_loadTitle;
+    QWebViewLoadRequestPrivate m_navigation; // timing of the current load
+
+    QList<QPair<QUrl, QString>> m_history; // URL and page title of each load
+    int m_historyIndex = -1;
+    QUrl m_url;
+    QString m_title;
+    QString m_httpUserAgent;
+    int m_loadProgress = 0;
+    bool m_loading = false;
+    QMap<QPair<QString, QString>, QString> m_cookies; // (domain, name) to value
+    // Bumped by reset(), deliveries queued for the previous owner are dropped
+    quint64 m_generation = 0;
+};
+
+class QFakeWebViewPlugin : public QWebViewPlugin
+{
+    Q_OBJECT
+public:
+    QAbstractWebView *create(const QString &key, QObject *parent = nullptr) const override;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWEBVIEWFAKEBACKEND_P_H
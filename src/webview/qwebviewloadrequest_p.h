@@ -34,6 +34,16 @@ public:
     QUrl m_url;
     QWebView::LoadStatus m_status;
     QString m_errorString;
+
+    // Identifies the navigation across its status changes, 0 if unknown
+    quint64 m_navigationId = 0;
+    // Monotonic timestamps in nanoseconds, 0 until the navigation reaches the phase
+    qint64 m_startedAt = 0;
+    qint64 m_redirectedAt = 0;
+    qint64 m_committedAt = 0;
+    qint64 m_finishedAt = 0;
+    // Status of the main resource response, known from commit on, 0 otherwise
+    int m_httpStatusCode = 0;
 };
 
 QT_END_NAMESPACE
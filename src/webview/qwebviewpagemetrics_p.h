@@ -0,0 +1,42 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QWEBVIEWPAGEMETRICS_P_H
+#define QWEBVIEWPAGEMETRICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qmetatype.h>
+#include <QtCore/qurl.h>
+
+QT_BEGIN_NAMESPACE
+
+// Reported once per navigation after the load event. Times are in milliseconds
+// since the start of the navigation, -1 when the page did not reach the point
+// or the engine does not report it.
+struct QWebViewPageMetrics
+{
+    QUrl url;
+    quint64 navigationId = 0; // matches QWebViewLoadRequestPrivate::m_navigationId
+    double firstPaint = -1;
+    double firstContentfulPaint = -1;
+    double domContentLoaded = -1;
+    double loadEvent = -1;
+    int longTaskCount = -1; // -1 if long tasks are not observable
+    double longTaskDuration = 0;
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QWebViewPageMetrics)
+
+#endif // QWEBVIEWPAGEMETRICS_P_H
@@ -20,9 +20,18 @@ QAbstractWebView *QWebViewPlugin::create(const QString &key, QObject *parent) co
     return nullptr;
 }
 
+QAbstractWebView *QWebViewPlugin::create(const QString &key, QObject *profile,
+                                         QObject *parent) const
+{
+    if (profile)
+        qWarning("Profiles are not supported by this WebView plug-in");
+    return create(key, parent);
+}
+
 void QWebViewPlugin::prepare() const
 {
-    // Only called for plugins that has "RequiresInit" set to true in their plugin metadata.
+    // Called once when the backend is first used, or at application startup for
+    // plugins that have "RequiresInit" set to true in their plugin metadata.
 }
 
 QT_END_NAMESPACE
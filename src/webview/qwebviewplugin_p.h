@@ -22,6 +22,8 @@
 
 QT_BEGIN_NAMESPACE
 
+#define QWebViewPluginInterface_iid "org.qt-project.Qt.QWebViewPluginInterface"
+
 class Q_WEBVIEW_EXPORT QWebViewPlugin : public QObject
 {
     Q_OBJECT
@@ -30,6 +32,8 @@ public:
     virtual ~QWebViewPlugin();
 
     virtual QAbstractWebView *create(const QString &key, QObject *parent = nullptr) const;
+    // The profile type is defined by the backend
+    virtual QAbstractWebView *create(const QString &key, QObject *profile, QObject *parent) const;
 
     virtual void prepare() const;
 };
@@ -0,0 +1,139 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qwebviewpool_p.h"
+#include "qwebviewfactory_p.h"
+#include "qwebviewloadrequest_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qtimer.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+static QPointer<QWebViewPool> s_pool;
+
+QWebViewPool *QWebViewPool::instance()
+{
+    if (!s_pool) {
+        QCoreApplication *app = QCoreApplication::instance();
+        if (!app)
+            return nullptr;
+        s_pool = new QWebViewPool(app);
+    }
+    return s_pool;
+}
+
+QWebViewPool::QWebViewPool(QObject *parent) : QObject(parent)
+{
+    bool ok = false;
+    const int size = qEnvironmentVariableIntValue("QT_WEBVIEW_POOL_SIZE", &ok);
+    if (ok && size > 0)
+        setSize(size);
+
+    // Backend views must go away while the platform integration is still alive
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this,
+            &QWebViewPool::clear);
+}
+
+void QWebViewPool::setSize(int size)
+{
+    m_size = qMax(0, size);
+    while (m_views.size() > m_size)
+        delete m_views.takeLast();
+    scheduleRefill();
+}
+
+QAbstractWebView *QWebViewPool::take(QObject *parent)
+{
+    if (m_views.isEmpty()) {
+        if (m_size > 0)
+            ++m_statistics.misses;
+        return nullptr;
+    }
+
+    ++m_statistics.hits;
+    QAbstractWebView *webView = m_views.takeFirst();
+    webView->setParent(parent);
+    scheduleRefill();
+    return webView;
+}
+
+bool QWebViewPool::recycle(QAbstractWebView *webView)
+{
+    if (!webView || m_views.size() >= m_size)
+        return false;
+
+    // Drop the connections of the previous owner and the first load tracking
+    // before resetting. The backend's own wiring stays, it is not redone when
+    // the view is taken again.
+    if (QObject *owner = webView->parent())
+        disconnect(webView, nullptr, owner, nullptr);
+    disconnect(webView, nullptr, this, nullptr);
+    if (!webView->reset()) {
+        ++m_statistics.discarded;
+        return false;
+    }
+
+    ++m_statistics.recycled;
+    webView->setParent(this);
+    m_views.append(webView);
+    return true;
+}
+
+void QWebViewPool::trackFirstLoad(QAbstractWebView *webView, qint64 requestedAt, bool pooled)
+{
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(webView, &QAbstractWebView::loadingChanged, this,
+                          [this, connection, requestedAt,
+                           pooled](const QWebViewLoadRequestPrivate &loadRequest) {
+                              // The blank page a backend resets to is not the owner's load
+                              if (loadRequest.m_status == QWebView::LoadStartedStatus
+                                  || loadRequest.m_status == QWebView::LoadRedirectedStatus
+                                  || loadRequest.m_status == QWebView::LoadCommittedStatus
+                                  || loadRequest.m_url == QUrl(QStringLiteral("about:blank")))
+                                  return;
+                              disconnect(*connection);
+                              const qint64 elapsed =
+                                      QDeadlineTimer::current().deadline() - requestedAt;
+                              if (pooled) {
+                                  ++m_statistics.pooledFirstLoads;
+                                  m_statistics.pooledTimeToFirstLoad += elapsed;
+                              } else {
+                                  ++m_statistics.coldFirstLoads;
+                                  m_statistics.coldTimeToFirstLoad += elapsed;
+                              }
+                          });
+}
+
+void QWebViewPool::scheduleRefill()
+{
+    if (m_refillPending || m_views.size() >= m_size)
+        return;
+
+    m_refillPending = true;
+    QTimer::singleShot(0, this, &QWebViewPool::refill);
+}
+
+void QWebViewPool::refill()
+{
+    m_refillPending = false;
+    if (m_views.size() >= m_size)
+        return;
+
+    // One view per event loop pass, so filling the pool never blocks the UI for long
+    m_views.append(QWebViewFactory::createUnpooledWebView(this));
+    scheduleRefill();
+}
+
+void QWebViewPool::clear()
+{
+    m_size = 0;
+    qDeleteAll(m_views);
+    m_views.clear();
+}
+
+QT_END_NAMESPACE
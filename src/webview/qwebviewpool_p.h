@@ -0,0 +1,88 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QWEBVIEWPOOL_P_H
+#define QWEBVIEWPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qabstractwebview_p.h"
+
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+struct Q_WEBVIEW_EXPORT QWebViewPoolStatistics
+{
+    int hits = 0;
+    int misses = 0;
+    int recycled = 0;
+    int discarded = 0;
+
+    // Time from createWebView() to the first finished load, in milliseconds,
+    // accumulated separately for pooled and freshly created views.
+    int pooledFirstLoads = 0;
+    qint64 pooledTimeToFirstLoad = 0;
+    int coldFirstLoads = 0;
+    qint64 coldTimeToFirstLoad = 0;
+
+    qreal hitRate() const
+    {
+        const int total = hits + misses;
+        return total ? qreal(hits) / total : qreal(0);
+    }
+    qint64 averagePooledTimeToFirstLoad() const
+    {
+        return pooledFirstLoads ? pooledTimeToFirstLoad / pooledFirstLoads : -1;
+    }
+    qint64 averageColdTimeToFirstLoad() const
+    {
+        return coldFirstLoads ? coldTimeToFirstLoad / coldFirstLoads : -1;
+    }
+};
+
+class QWebViewPool : public QObject
+{
+    Q_OBJECT
+public:
+    // Returns nullptr until a QCoreApplication exists
+    static QWebViewPool *instance();
+
+    int size() const { return m_size; }
+    void setSize(int size);
+    int available() const { return m_views.size(); }
+
+    QAbstractWebView *take(QObject *parent);
+    bool recycle(QAbstractWebView *webView);
+    void trackFirstLoad(QAbstractWebView *webView, qint64 requestedAt, bool pooled);
+
+    QWebViewPoolStatistics statistics() const { return m_statistics; }
+    void resetStatistics() { m_statistics = QWebViewPoolStatistics(); }
+
+private Q_SLOTS:
+    void refill();
+    void clear();
+
+private:
+    explicit QWebViewPool(QObject *parent);
+    void scheduleRefill();
+
+    QList<QAbstractWebView *> m_views;
+    QWebViewPoolStatistics m_statistics;
+    int m_size = 0;
+    bool m_refillPending = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWEBVIEWPOOL_P_H
@@ -0,0 +1,216 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qwebviewrenderqueue_p.h"
+#include "qwebviewfactory_p.h"
+#include "qwebviewloadrequest_p.h"
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
+
+QT_BEGIN_NAMESPACE
+
+QWebViewRenderQueue::QWebViewRenderQueue(QObject *parent)
+    : QObject(parent), m_maximumConcurrency(qMax(1, QThread::idealThreadCount()))
+{
+}
+
+QWebViewRenderQueue::~QWebViewRenderQueue()
+{
+    // The views' connections refer to their slots
+    for (Slot *slot : m_slots)
+        delete slot->view;
+    qDeleteAll(m_slots);
+}
+
+void QWebViewRenderQueue::setMaximumConcurrency(int count)
+{
+    m_maximumConcurrency = qMax(1, count);
+
+    // Busy views finish their job and are dropped on the next idle check
+    for (int i = m_slots.size() - 1; i >= 0 && m_slots.size() > m_maximumConcurrency; --i) {
+        Slot *slot = m_slots.at(i);
+        if (slot->busy)
+            continue;
+        delete slot->view;
+        delete slot;
+        m_slots.removeAt(i);
+    }
+    schedule();
+}
+
+int QWebViewRenderQueue::enqueue(const QWebViewRenderJob &job)
+{
+    PendingJob pending{ m_nextJobId++, job, QElapsedTimer() };
+    pending.timer.start();
+    m_pending.enqueue(pending);
+    schedule();
+    return pending.id;
+}
+
+void QWebViewRenderQueue::clear()
+{
+    m_pending.clear();
+}
+
+int QWebViewRenderQueue::activeCount() const
+{
+    int count = 0;
+    for (const Slot *slot : m_slots)
+        count += slot->busy ? 1 : 0;
+    return count;
+}
+
+void QWebViewRenderQueue::schedule()
+{
+    while (!m_pending.isEmpty()) {
+        Slot *slot = nullptr;
+        for (Slot *candidate : m_slots) {
+            if (!candidate->busy) {
+                slot = candidate;
+                break;
+            }
+        }
+        if (!slot) {
+            if (m_slots.size() >= m_maximumConcurrency)
+                return;
+            slot = createSlot();
+        }
+        start(slot, m_pending.dequeue());
+    }
+}
+
+QWebViewRenderQueue::Slot *QWebViewRenderQueue::createSlot()
+{
+    Slot *slot = new Slot;
+    slot->view = QWebViewFactory::createOffscreenWebView(this);
+    slot->timeout = new QTimer(slot->view);
+    slot->timeout->setSingleShot(true);
+    slot->settle = new QTimer(slot->view);
+    slot->settle->setSingleShot(true);
+
+    connect(slot->view, &QAbstractWebView::loadingChanged, this,
+            [this, slot](const QWebViewLoadRequestPrivate &loadRequest) {
+                onLoadingChanged(slot, loadRequest);
+            });
+    connect(slot->view, &QAbstractWebView::snapshotReady, this,
+            [this, slot](int callbackId, const QImage &image) {
+                onSnapshotReady(slot, callbackId, image);
+            });
+    connect(slot->timeout, &QTimer::timeout, this, [this, slot]() {
+        slot->view->stop();
+        finish(slot, false, QStringLiteral("Timed out"));
+    });
+    connect(slot->settle, &QTimer::timeout, this, [slot]() {
+        slot->result.settleTime = slot->phase.restart();
+        slot->view->grabSnapshot(slot->current.job.region, slot->current.job.targetSize,
+                                 slot->current.id);
+    });
+
+    m_slots.append(slot);
+    return slot;
+}
+
+void QWebViewRenderQueue::start(Slot *slot, const PendingJob &job)
+{
+    slot->busy = true;
+    slot->loadStarted = false;
+    slot->navigationId = 0;
+    slot->startedAt = QDeadlineTimer::current().deadlineNSecs();
+    slot->current = job;
+    slot->result = QWebViewRenderResult();
+    slot->result.jobId = job.id;
+    slot->result.url = job.job.html.isEmpty() ? job.job.url : job.job.baseUrl;
+    slot->result.queueTime = job.timer.elapsed();
+    slot->phase.start();
+
+    if (m_timeout > 0)
+        slot->timeout->start(m_timeout);
+    if (job.job.html.isEmpty())
+        slot->view->setUrl(job.job.url);
+    else
+        slot->view->loadHtml(job.job.html, job.job.baseUrl);
+}
+
+void QWebViewRenderQueue::onLoadingChanged(Slot *slot,
+                                           const QWebViewLoadRequestPrivate &loadRequest)
+{
+    if (!slot->busy || slot->settle->isActive())
+        return;
+
+    // Events of the previous job, stopped on timeout, may still be queued. The
+    // job's load is the first one started after the job, the other loads of
+    // backends that identify their navigations are ignored. Without an id,
+    // events queued by the previous job arrive before this job's start.
+    if (loadRequest.m_navigationId) {
+        if (!slot->navigationId && loadRequest.m_status == QWebView::LoadStartedStatus
+            && loadRequest.m_startedAt >= slot->startedAt)
+            slot->navigationId = loadRequest.m_navigationId;
+        if (loadRequest.m_navigationId != slot->navigationId)
+            return;
+    }
+
+    switch (loadRequest.m_status) {
+    case QWebView::LoadStartedStatus:
+        slot->loadStarted = true;
+        return;
+    case QWebView::LoadFailedStatus:
+        if (slot->loadStarted)
+            finish(slot, false, loadRequest.m_errorString);
+        return;
+    case QWebView::LoadStoppedStatus:
+    case QWebView::LoadSucceededStatus:
+        if (slot->loadStarted)
+            break;
+        return;
+    default:
+        return;
+    }
+
+    slot->result.loadTime = slot->phase.restart();
+    const int delay = slot->current.job.settleDelay >= 0 ? slot->current.job.settleDelay
+                                                          : m_settleDelay;
+    slot->settle->start(delay);
+}
+
+void QWebViewRenderQueue::onSnapshotReady(Slot *slot, int callbackId, const QImage &image)
+{
+    if (!slot->busy || callbackId != slot->current.id)
+        return;
+
+    slot->result.snapshotTime = slot->phase.elapsed();
+    slot->result.image = image;
+    finish(slot, !image.isNull(), image.isNull() ? QStringLiteral("Snapshot failed") : QString());
+}
+
+void QWebViewRenderQueue::finish(Slot *slot, bool ok, const QString &errorString)
+{
+    slot->timeout->stop();
+    slot->settle->stop();
+    slot->busy = false;
+
+    QWebViewRenderResult result = slot->result;
+    result.ok = ok;
+    result.errorString = errorString;
+    slot->result = QWebViewRenderResult();
+
+    emit jobFinished(result);
+
+    if (m_slots.size() > m_maximumConcurrency) {
+        m_slots.removeOne(slot);
+        // finish() may run from the view's own signal, the view goes later. Its
+        // pending signals must not reach the lambdas holding the slot meanwhile.
+        disconnect(slot->view, nullptr, this, nullptr);
+        disconnect(slot->timeout, nullptr, this, nullptr);
+        disconnect(slot->settle, nullptr, this, nullptr);
+        slot->view->deleteLater();
+        delete slot;
+    }
+
+    schedule();
+    if (m_pending.isEmpty() && activeCount() == 0)
+        emit finished();
+}
+
+QT_END_NAMESPACE
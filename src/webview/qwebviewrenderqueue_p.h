@@ -0,0 +1,126 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QWEBVIEWRENDERQUEUE_P_H
+#define QWEBVIEWRENDERQUEUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qabstractwebview_p.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qqueue.h>
+
+QT_BEGIN_NAMESPACE
+
+class QTimer;
+class QWebViewLoadRequestPrivate;
+
+struct Q_WEBVIEW_EXPORT QWebViewRenderJob
+{
+    QUrl url; // loaded when html is empty
+    QString html;
+    QUrl baseUrl;
+    QAbstractWebView::SnapshotRegion region = QAbstractWebView::VisibleSnapshotRegion;
+    QSize targetSize;
+    int settleDelay = -1; // msecs, -1 uses the queue's
+};
+
+struct Q_WEBVIEW_EXPORT QWebViewRenderResult
+{
+    int jobId = 0;
+    QUrl url;
+    QImage image;
+    bool ok = false;
+    QString errorString;
+
+    // Milliseconds spent in each phase
+    qint64 queueTime = 0;
+    qint64 loadTime = 0;
+    qint64 settleTime = 0;
+    qint64 snapshotTime = 0;
+    qint64 totalTime() const { return queueTime + loadTime + settleTime + snapshotTime; }
+};
+
+// Renders jobs to images on up to maximumConcurrency() views, which are
+// created on demand and reused for the following jobs.
+class Q_WEBVIEW_EXPORT QWebViewRenderQueue : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QWebViewRenderQueue(QObject *parent = nullptr);
+    ~QWebViewRenderQueue() override;
+
+    // Defaults to the number of cores
+    int maximumConcurrency() const { return m_maximumConcurrency; }
+    void setMaximumConcurrency(int count);
+    // Wait after the load has finished, for late scripts and layout
+    int settleDelay() const { return m_settleDelay; }
+    void setSettleDelay(int msecs) { m_settleDelay = qMax(0, msecs); }
+    // Per job, from start of the load to the snapshot, 0 disables it
+    int timeout() const { return m_timeout; }
+    void setTimeout(int msecs) { m_timeout = qMax(0, msecs); }
+
+    int enqueue(const QWebViewRenderJob &job);
+    // Drops the jobs that have not started yet
+    void clear();
+
+    int pendingCount() const { return m_pending.size(); }
+    int activeCount() const;
+
+Q_SIGNALS:
+    void jobFinished(const QWebViewRenderResult &result);
+    void finished(); // no job left
+
+private:
+    struct PendingJob
+    {
+        int id;
+        QWebViewRenderJob job;
+        QElapsedTimer timer;
+    };
+    struct Slot
+    {
+        QAbstractWebView *view = nullptr;
+        QTimer *timeout = nullptr;
+        QTimer *settle = nullptr;
+        bool busy = false;
+        bool loadStarted = false;
+        quint64 navigationId = 0; // of the job's load, once it started
+        qint64 startedAt = 0; // monotonic nsecs, when the job started
+        PendingJob current;
+        QWebViewRenderResult result;
+        QElapsedTimer phase;
+    };
+
+    void schedule();
+    Slot *createSlot();
+    void start(Slot *slot, const PendingJob &job);
+    void onLoadingChanged(Slot *slot, const QWebViewLoadRequestPrivate &loadRequest);
+    void onSnapshotReady(Slot *slot, int callbackId, const QImage &image);
+    void finish(Slot *slot, bool ok, const QString &errorString);
+
+    QQueue<PendingJob> m_pending;
+    QList<Slot *> m_slots;
+    int m_maximumConcurrency;
+    int m_settleDelay = 0;
+    int m_timeout = 30000;
+    int m_nextJobId = 1;
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QWebViewRenderResult)
+
+#endif // QWEBVIEWRENDERQUEUE_P_H
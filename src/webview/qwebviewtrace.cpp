@@ -0,0 +1,239 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qwebviewtrace_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvector.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct TraceEvent
+{
+    enum Kind { Instant, Complete, Queued };
+
+    const char *name;
+    Kind kind;
+    quint64 navigationId;
+    qint64 timestamp; // nsecs
+    qint64 duration; // nsecs
+    int thread;
+};
+
+struct TraceBuffer
+{
+    QMutex mutex;
+    QVector<TraceEvent> events;
+    QVector<QString> threadNames; // indexed by TraceEvent::thread
+    quint64 droppedEvents = 0;
+    const QString fileName = qEnvironmentVariable("QT_WEBVIEW_TRACE_FILE");
+};
+
+// About 48 MB, a trace that outgrows it has stopped being readable anyway
+static const int maximumEvents = 1 << 20;
+
+std::atomic<bool> traceEnabled{ false };
+thread_local int currentThreadIndex = -1;
+} // namespace
+
+Q_GLOBAL_STATIC(TraceBuffer, traceBuffer)
+
+static void writeTraceFile()
+{
+    QWebViewTrace::writeChromeTrace(traceBuffer->fileName);
+}
+
+static void record(const char *name, TraceEvent::Kind kind, quint64 navigationId,
+                   qint64 timestamp, qint64 duration = 0)
+{
+    // Late events from threads outliving the application are dropped
+    if (traceBuffer.isDestroyed())
+        return;
+
+    TraceBuffer *buffer = traceBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= maximumEvents) {
+        ++buffer->droppedEvents;
+        return;
+    }
+
+    if (currentThreadIndex < 0) {
+        currentThreadIndex = buffer->threadNames.size();
+        QString threadName = QThread::currentThread()->objectName();
+        if (threadName.isEmpty()) {
+            const QCoreApplication *application = QCoreApplication::instance();
+            threadName = application && QThread::currentThread() == application->thread()
+                    ? QStringLiteral("GUI")
+                    : QStringLiteral("Thread %1").arg(currentThreadIndex);
+        }
+        buffer->threadNames.append(threadName);
+    }
+
+    buffer->events.append(
+            TraceEvent{ name, kind, navigationId, timestamp, duration, currentThreadIndex });
+}
+
+bool QWebViewTrace::isEnabled()
+{
+    static const bool fromEnvironment = []() {
+        if (traceBuffer->fileName.isEmpty())
+            return false;
+        traceEnabled.store(true, std::memory_order_relaxed);
+        qAddPostRoutine(writeTraceFile);
+        return true;
+    }();
+    Q_UNUSED(fromEnvironment);
+    return traceEnabled.load(std::memory_order_relaxed);
+}
+
+void QWebViewTrace::setEnabled(bool enabled)
+{
+    isEnabled(); // reads the environment first, so it cannot override this
+    traceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void QWebViewTrace::instant(const char *name, quint64 navigationId)
+{
+    if (isEnabled())
+        record(name, TraceEvent::Instant, navigationId, QDeadlineTimer::current().deadlineNSecs());
+}
+
+void QWebViewTrace::complete(const char *name, qint64 startedAt, quint64 navigationId)
+{
+    if (isEnabled())
+        record(name, TraceEvent::Complete, navigationId, startedAt,
+               QDeadlineTimer::current().deadlineNSecs() - startedAt);
+}
+
+void QWebViewTrace::queued(const char *name, qint64 postedAt, quint64 navigationId)
+{
+    if (isEnabled())
+        record(name, TraceEvent::Queued, navigationId, postedAt,
+               QDeadlineTimer::current().deadlineNSecs() - postedAt);
+}
+
+QByteArray QWebViewTrace::toChromeTraceJson()
+{
+    if (traceBuffer.isDestroyed())
+        return QByteArray();
+
+    TraceBuffer *buffer = traceBuffer();
+    QMutexLocker locker(&buffer->mutex);
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json;
+    json.reserve(128 * (buffer->events.size() + buffer->threadNames.size()) + 128);
+    json += "{\"traceEvents\":[";
+
+    bool first = true;
+    for (int i = 0; i < buffer->threadNames.size(); ++i) {
+        const QJsonObject metadata{
+            { QStringLiteral("name"), QStringLiteral("thread_name") },
+            { QStringLiteral("ph"), QStringLiteral("M") },
+            { QStringLiteral("pid"), QCoreApplication::applicationPid() },
+            { QStringLiteral("tid"), i },
+            { QStringLiteral("args"),
+              QJsonObject{ { QStringLiteral("name"), buffer->threadNames.at(i) } } },
+        };
+        if (!first)
+            json += ',';
+        first = false;
+        json += QJsonDocument(metadata).toJson(QJsonDocument::Compact);
+    }
+
+    // Timestamps in usecs, as the format wants them. Queued spans become a
+    // begin and end pair of async events, told apart by their sequence number.
+    for (int i = 0; i < buffer->events.size(); ++i) {
+        const TraceEvent &event = buffer->events.at(i);
+        const int parts = event.kind == TraceEvent::Queued ? 2 : 1;
+        for (int part = 0; part < parts; ++part) {
+            if (!first)
+                json += ',';
+            first = false;
+            json += "{\"name\":\"";
+            json += event.name;
+            json += "\",\"cat\":\"qtwebview\",\"ph\":\"";
+            switch (event.kind) {
+            case TraceEvent::Instant:
+                json += "i\",\"s\":\"t";
+                break;
+            case TraceEvent::Complete:
+                json += 'X';
+                break;
+            case TraceEvent::Queued:
+                json += part == 0 ? 'b' : 'e';
+                json += "\",\"id\":\"";
+                json += QByteArray::number(i);
+                break;
+            }
+            json += "\",\"ts\":";
+            json += QByteArray::number((event.timestamp + part * event.duration) / 1000.0, 'f', 3);
+            if (event.kind == TraceEvent::Complete) {
+                json += ",\"dur\":";
+                json += QByteArray::number(event.duration / 1000.0, 'f', 3);
+            }
+            json += ",\"pid\":";
+            json += pid;
+            json += ",\"tid\":";
+            json += QByteArray::number(event.thread);
+            if (event.navigationId) {
+                json += ",\"args\":{\"navigationId\":";
+                json += QByteArray::number(event.navigationId);
+                json += '}';
+            }
+            json += '}';
+        }
+    }
+
+    json += "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":";
+    json += QByteArray::number(buffer->droppedEvents);
+    json += "}}";
+    return json;
+}
+
+bool QWebViewTrace::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(toChromeTraceJson()) < 0) {
+        qWarning("Cannot write WebView trace to \"%s\": %s", qPrintable(fileName),
+                 qPrintable(file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+void QWebViewTrace::clear()
+{
+    if (traceBuffer.isDestroyed())
+        return;
+    // Thread names stay, the threads keep their index
+    QMutexLocker locker(&traceBuffer->mutex);
+    traceBuffer->events.clear();
+    traceBuffer->droppedEvents = 0;
+}
+
+QWebViewTraceSpan::QWebViewTraceSpan(const char *name, quint64 navigationId)
+    : m_name(name),
+      m_navigationId(navigationId),
+      m_startedAt(QWebViewTrace::isEnabled() ? QDeadlineTimer::current().deadlineNSecs() : 0)
+{
+}
+
+QWebViewTraceSpan::~QWebViewTraceSpan()
+{
+    if (m_startedAt)
+        QWebViewTrace::complete(m_name, m_startedAt, m_navigationId);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,87 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QWEBVIEWTRACE_P_H
+#define QWEBVIEWTRACE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qwebview_global.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+// Spans and instant events, exported as Chrome trace-event JSON for
+// chrome://tracing or Perfetto.
+//
+// Call sites use the Q_WEBVIEW_TRACE_* macros, which compile to nothing unless
+// the build is configured with -DQT_WEBVIEW_TRACING=ON. Even then events are
+// only recorded while tracing is enabled, either with setEnabled() or by
+// naming the output file in QT_WEBVIEW_TRACE_FILE, which is written when the
+// application exits. Names must be string literals, they are stored as is.
+class Q_WEBVIEW_EXPORT QWebViewTrace
+{
+public:
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    static void instant(const char *name, quint64 navigationId = 0);
+    static void complete(const char *name, qint64 startedAt, quint64 navigationId = 0);
+    // Time from postedAt until now as an async span of its own, for work
+    // handed to another thread, where a span would overlap the receiver's.
+    static void queued(const char *name, qint64 postedAt, quint64 navigationId = 0);
+
+    static QByteArray toChromeTraceJson();
+    static bool writeChromeTrace(const QString &fileName);
+    static void clear();
+};
+
+class Q_WEBVIEW_EXPORT QWebViewTraceSpan
+{
+public:
+    explicit QWebViewTraceSpan(const char *name, quint64 navigationId = 0);
+    ~QWebViewTraceSpan();
+
+private:
+    Q_DISABLE_COPY(QWebViewTraceSpan)
+
+    const char *m_name;
+    quint64 m_navigationId;
+    qint64 m_startedAt;
+};
+
+#ifdef QT_WEBVIEW_TRACING
+#  define Q_WEBVIEW_TRACE_SPAN(name) QWebViewTraceSpan qWebViewTraceSpan(name)
+#  define Q_WEBVIEW_TRACE_NAVIGATION_SPAN(name, navigationId)                                 \
+      QWebViewTraceSpan qWebViewTraceSpan(name, navigationId)
+#  define Q_WEBVIEW_TRACE_INSTANT(name) QWebViewTrace::instant(name)
+#  define Q_WEBVIEW_TRACE_NAVIGATION_INSTANT(name, navigationId)                              \
+      QWebViewTrace::instant(name, navigationId)
+#  define Q_WEBVIEW_TRACE_QUEUED(name, postedAt, navigationId)                                \
+      QWebViewTrace::queued(name, postedAt, navigationId)
+#else
+#  define Q_WEBVIEW_TRACE_SPAN(name) do { } while (false)
+#  define Q_WEBVIEW_TRACE_NAVIGATION_SPAN(name, navigationId) do { } while (false)
+#  define Q_WEBVIEW_TRACE_INSTANT(name) do { } while (false)
+#  define Q_WEBVIEW_TRACE_NAVIGATION_INSTANT(name, navigationId) do { } while (false)
+#  define Q_WEBVIEW_TRACE_QUEUED(name, postedAt, navigationId)                                \
+      do {                                                                                    \
+          Q_UNUSED(postedAt);                                                                 \
+          Q_UNUSED(navigationId);                                                             \
+      } while (false)
+#endif
+
+QT_END_NAMESPACE
+
+#endif // QWEBVIEWTRACE_P_H
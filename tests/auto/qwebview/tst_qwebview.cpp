@@ -0,0 +1,266 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest/QtTest>
+
+#include <qwebview_p.h>
+#include <qwebviewfactory_p.h>
+#include <qwebviewfakebackend_p.h>
+#include <qwebviewloadrequest_p.h>
+
+class tst_QWebView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void timelineReplay();
+    void timelineFailedLoad();
+    void timelineFromJson();
+    void resetDropsStaleDeliveries();
+    void resetRestoresUserAgent();
+    void javaScriptHandler();
+    void cookies();
+    void cookieEvents();
+
+private:
+    static QFakeWebView *fakeBackend(QWebView &view)
+    {
+        return qobject_cast<QFakeWebView *>(view.d);
+    }
+};
+
+void tst_QWebView::initTestCase()
+{
+    QWebView view;
+    if (!fakeBackend(view))
+        QSKIP("Needs the fake backend, QT_WEBVIEW_PLUGIN=fake");
+}
+
+void tst_QWebView::cleanup()
+{
+    QWebViewFactory::setPoolSize(0);
+}
+
+void tst_QWebView::timelineReplay()
+{
+    QWebView view;
+    fakeBackend(view)->setTimeline({
+            { QFakeWebViewEvent::LoadStarted, 0, QVariant() },
+            { QFakeWebViewEvent::Url, 0, QVariant() },
+            { QFakeWebViewEvent::Progress, 5, 40 },
+            { QFakeWebViewEvent::LoadRedirected, 0, QStringLiteral("https://example.org/b") },
+            { QFakeWebViewEvent::LoadCommitted, 5, 201 },
+            { QFakeWebViewEvent::Title, 0, QStringLiteral("Scripted") },
+            { QFakeWebViewEvent::Progress, 0, 100 },
+            { QFakeWebViewEvent::LoadSucceeded, 0, QVariant() },
+    });
+
+    QList<QWebViewLoadRequestPrivate> requests;
+    connect(&view, &QWebView::loadingChanged, this,
+            [&requests](const QWebViewLoadRequestPrivate &request) { requests.append(request); });
+
+    const QUrl url(QStringLiteral("https://example.org/a"));
+    view.setUrl(url);
+    // Even the first event comes from the event loop
+    QVERIFY(requests.isEmpty());
+    QTRY_COMPARE(requests.size(), 4);
+
+    QCOMPARE(requests.at(0).m_status, QWebView::LoadStartedStatus);
+    QCOMPARE(requests.at(0).m_url, url);
+    QCOMPARE(requests.at(1).m_status, QWebView::LoadRedirectedStatus);
+    QCOMPARE(requests.at(1).m_url, QUrl(QStringLiteral("https://example.org/b")));
+    QCOMPARE(requests.at(2).m_status, QWebView::LoadCommittedStatus);
+    QCOMPARE(requests.at(2).m_httpStatusCode, 201);
+    QCOMPARE(requests.at(3).m_status, QWebView::LoadSucceededStatus);
+
+    // One navigation, timed in order
+    const QWebViewLoadRequestPrivate &finished = requests.at(3);
+    for (const QWebViewLoadRequestPrivate &request : requests)
+        QCOMPARE(request.m_navigationId, finished.m_navigationId);
+    QVERIFY(finished.m_startedAt > 0);
+    QVERIFY(finished.m_redirectedAt >= finished.m_startedAt);
+    QVERIFY(finished.m_committedAt >= finished.m_redirectedAt);
+    QVERIFY(finished.m_finishedAt >= finished.m_committedAt);
+
+    QCOMPARE(view.title(), QStringLiteral("Scripted"));
+    QCOMPARE(view.loadProgress(), 100);
+    QCOMPARE(view.url(), QUrl(QStringLiteral("https://example.org/b")));
+    QVERIFY(!view.isLoading());
+}
+
+void tst_QWebView::timelineFailedLoad()
+{
+    QWebView view;
+    fakeBackend(view)->setTimeline({
+            { QFakeWebViewEvent::LoadStarted, 0, QVariant() },
+            { QFakeWebViewEvent::Progress, 0, 30 },
+            { QFakeWebViewEvent::LoadFailed, 0, QStringLiteral("Host not found") },
+    });
+
+    QList<QWebViewLoadRequestPrivate> requests;
+    connect(&view, &QWebView::loadingChanged, this,
+            [&requests](const QWebViewLoadRequestPrivate &request) { requests.append(request); });
+
+    view.setUrl(QUrl(QStringLiteral("https://example.org/")));
+    QTRY_COMPARE(requests.size(), 2);
+    QCOMPARE(requests.at(1).m_status, QWebView::LoadFailedStatus);
+    QCOMPARE(requests.at(1).m_errorString, QStringLiteral("Host not found"));
+    QCOMPARE(view.loadProgress(), 0);
+}
+
+void tst_QWebView::timelineFromJson()
+{
+    QString errorString;
+    const QFakeWebViewTimeline timeline = QFakeWebView::timelineFromJson(
+            R"([{ "type": "load-started" },
+                { "type": "progress", "delay": 10, "value": 50 },
+                { "type": "cookie-added", "value": ["example.org", "session", "1"] }])",
+            &errorString);
+    QVERIFY2(errorString.isEmpty(), qPrintable(errorString));
+    QCOMPARE(timeline.size(), 3);
+    QCOMPARE(timeline.at(0).type, QFakeWebViewEvent::LoadStarted);
+    QCOMPARE(timeline.at(1).type, QFakeWebViewEvent::Progress);
+    QCOMPARE(timeline.at(1).delay, 10);
+    QCOMPARE(timeline.at(1).value.toInt(), 50);
+    QCOMPARE(timeline.at(2).type, QFakeWebViewEvent::CookieAdded);
+    QCOMPARE(timeline.at(2).value.toStringList().size(), 3);
+
+    QVERIFY(QFakeWebView::timelineFromJson(R"([{ "type": "explode" }])", &errorString)
+                    .isEmpty());
+    QVERIFY(errorString.contains(QStringLiteral("explode")));
+
+    errorString.clear();
+    QVERIFY(QFakeWebView::timelineFromJson("{}", &errorString).isEmpty());
+    QVERIFY(!errorString.isEmpty());
+}
+
+// A recycled view must not hand the previous owner's results to the next one
+void tst_QWebView::resetDropsStaleDeliveries()
+{
+    QFakeWebView view;
+    view.setJavaScriptHandler([](const QString &) { return QVariant(1); });
+    QSignalSpy javaScriptSpy(&view, &QAbstractWebView::javaScriptResult);
+    QSignalSpy cookieAddedSpy(&view, &QAbstractWebView::cookieAdded);
+    QSignalSpy cookieRemovedSpy(&view, &QAbstractWebView::cookieRemoved);
+    QSignalSpy snapshotSpy(&view, &QAbstractWebView::snapshotReady);
+    QSignalSpy loadingSpy(&view, &QAbstractWebView::loadingChanged);
+
+    view.setUrl(QUrl(QStringLiteral("https://example.org/")));
+    view.runJavaScriptPrivate(QStringLiteral("1"), 7);
+    view.setCookie(QStringLiteral("example.org"), QStringLiteral("a"), QStringLiteral("1"));
+    view.deleteAllCookies();
+    view.grabSnapshot(QAbstractWebView::VisibleSnapshotRegion, QSize(), 3);
+    QVERIFY(view.reset());
+
+    // Everything queued above belongs to the previous generation
+    QTest::qWait(50);
+    QCOMPARE(javaScriptSpy.count(), 0);
+    QCOMPARE(cookieAddedSpy.count(), 0);
+    QCOMPARE(cookieRemovedSpy.count(), 0);
+    QCOMPARE(snapshotSpy.count(), 0);
+    QCOMPARE(loadingSpy.count(), 0);
+    QVERIFY(view.title().isEmpty());
+    QVERIFY(!view.canGoBack());
+
+    // The new generation is delivered
+    view.runJavaScriptPrivate(QStringLiteral("1"), 8);
+    QTRY_COMPARE(javaScriptSpy.count(), 1);
+    QCOMPARE(javaScriptSpy.at(0).at(0).toInt(), 8);
+}
+
+void tst_QWebView::resetRestoresUserAgent()
+{
+    QFakeWebView view;
+    const QString defaultUserAgent = view.httpUserAgent();
+    view.setHttpUserAgent(QStringLiteral("Custom/1.0"));
+    QVERIFY(view.reset());
+    QCOMPARE(view.httpUserAgent(), defaultUserAgent);
+
+    // The next owner of a pooled view starts with the default
+    QWebViewFactory::setPoolSize(1);
+    {
+        QWebView owner;
+        owner.setHttpUserAgent(QStringLiteral("Custom/1.0"));
+        QTRY_COMPARE(owner.httpUserAgent(), QStringLiteral("Custom/1.0"));
+    }
+    QWebView next;
+    QCOMPARE(next.httpUserAgent(), defaultUserAgent);
+}
+
+void tst_QWebView::javaScriptHandler()
+{
+    QWebView view;
+    QStringList scripts;
+    fakeBackend(view)->setJavaScriptHandler([&scripts](const QString &script) {
+        scripts.append(script);
+        return QVariant(script.size());
+    });
+    QSignalSpy spy(&view, &QWebView::javaScriptResult);
+
+    view.runJavaScriptPrivate(QStringLiteral("document.title"), 1);
+    view.runJavaScriptPrivate(QStringLiteral("42"), 2);
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(scripts, QStringList({ QStringLiteral("document.title"), QStringLiteral("42") }));
+    QCOMPARE(spy.at(0).at(0).toInt(), 1);
+    QCOMPARE(spy.at(0).at(1).toInt(), 14);
+    QCOMPARE(spy.at(1).at(0).toInt(), 2);
+    QCOMPARE(spy.at(1).at(1).toInt(), 2);
+
+    // Disabled JavaScript answers null
+    view.getSettings()->setJavaScriptEnabled(false);
+    view.runJavaScriptPrivate(QStringLiteral("1"), 3);
+    QTRY_COMPARE(spy.count(), 3);
+    QVERIFY(spy.at(2).at(1).isNull());
+    QCOMPARE(scripts.size(), 2);
+}
+
+void tst_QWebView::cookies()
+{
+    QWebView view;
+    QSignalSpy addedSpy(&view, &QWebView::cookieAdded);
+    QSignalSpy removedSpy(&view, &QWebView::cookieRemoved);
+
+    const QString domain = QStringLiteral("example.org");
+    view.setCookie(domain, QStringLiteral("a"), QStringLiteral("1"));
+    view.setCookie(domain, QStringLiteral("b"), QStringLiteral("2"));
+    QTRY_COMPARE(addedSpy.count(), 2);
+    QCOMPARE(addedSpy.at(0), QVariantList({ domain, QStringLiteral("a") }));
+
+    view.deleteCookie(domain, QStringLiteral("a"));
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0), QVariantList({ domain, QStringLiteral("a") }));
+
+    // Unknown cookies are not reported
+    view.deleteCookie(domain, QStringLiteral("a"));
+    view.deleteAllCookies();
+    QTRY_COMPARE(removedSpy.count(), 2);
+    QCOMPARE(removedSpy.at(1), QVariantList({ domain, QStringLiteral("b") }));
+}
+
+void tst_QWebView::cookieEvents()
+{
+    QWebView view;
+    fakeBackend(view)->setTimeline({
+            { QFakeWebViewEvent::LoadStarted, 0, QVariant() },
+            { QFakeWebViewEvent::CookieAdded, 0,
+              QStringList({ QStringLiteral("example.org"), QStringLiteral("session"),
+                            QStringLiteral("1") }) },
+            { QFakeWebViewEvent::CookieRemoved, 0,
+              QStringList({ QStringLiteral("example.org"), QStringLiteral("session") }) },
+            { QFakeWebViewEvent::LoadSucceeded, 0, QVariant() },
+    });
+    QSignalSpy addedSpy(&view, &QWebView::cookieAdded);
+    QSignalSpy removedSpy(&view, &QWebView::cookieRemoved);
+
+    view.setUrl(QUrl(QStringLiteral("https://example.org/")));
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(addedSpy.at(0).at(1).toString(), QStringLiteral("session"));
+}
+
+QTEST_MAIN(tst_QWebView)
+
+#include "tst_qwebview.moc"
@@ -0,0 +1,241 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest/QtTest>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtGui/qwindow.h>
+
+#include "webviewbenchmarkutils.h"
+
+#include <memory>
+#include <vector>
+
+// Runs of each stall measurement, the worst one is reported
+static const int stallRuns = 5;
+
+// Counts the resize events the page gets, one per relayout at a new size
+static const char resizeCounterPage[] =
+        "<html><body><script>"
+        "window.resizes = 0; addEventListener('resize', () => ++window.resizes);"
+        "</script></body></html>";
+
+// An interactive resize: width and height change one after the other, with
+// frameTime msecs between steps. 0 only runs the events of each step.
+static void dragResize(QWindow *window, const QSize &from, int steps, int frameTime)
+{
+    for (int step = 1; step <= steps; ++step) {
+        const int width = from.width() + step * 8;
+        window->resize(width, from.height() + (step - 1) * 6);
+        window->resize(width, from.height() + step * 6);
+        if (frameTime > 0)
+            QTest::qWait(frameTime);
+        else
+            QCoreApplication::processEvents();
+    }
+}
+
+// Waits until the page has been laid out at the size of the window
+static bool waitForPageSize(QWebView &view, const QSize &size)
+{
+    const QString expected = QStringLiteral("%1x%2").arg(size.width()).arg(size.height());
+    QDeadlineTimer deadline(10000);
+    while (!deadline.hasExpired()) {
+        if (runJavaScript(view, QStringLiteral("innerWidth + 'x' + innerHeight")).toString()
+            == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class tst_bench_QLinuxWebView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void dispatchRoundTrip();
+    void uiStallDuringLoad_data();
+    void uiStallDuringLoad();
+    void uiStallDuringJavaScript();
+    void uiStallDuringConcurrentLoads();
+    void dragResize_data();
+    void dragResize();
+    void dragResizeRelayouts_data() { dragResize_data(); }
+    void dragResizeRelayouts();
+
+private:
+    // An embedded view in a shown window, with the resize counter loaded
+    bool showResizablePage(QWebView &view, QWindow &host);
+};
+
+void tst_bench_QLinuxWebView::initTestCase()
+{
+    QWebView probe;
+    if (qstrcmp(QWebView::get(probe)->metaObject()->className(), "QLinuxWebViewPrivate") != 0)
+        QSKIP("Needs the Linux backend, QT_WEBVIEW_PLUGIN=linux");
+    qInfo("GTK thread: %s",
+          qEnvironmentVariableIntValue("QT_WEBVIEW_LINUX_GTK_THREAD") ? "dedicated" : "GUI");
+}
+
+// A command to WebKit and its result back on the GUI thread
+void tst_bench_QLinuxWebView::dispatchRoundTrip()
+{
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    QBENCHMARK {
+        QCOMPARE(runJavaScript(view, QStringLiteral("1")).toInt(), 1);
+    }
+}
+
+void tst_bench_QLinuxWebView::uiStallDuringLoad_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1 MB") << 1024 * 1024;
+    QTest::newRow("10 MB") << 10 * 1024 * 1024;
+}
+
+// The longest the GUI thread is blocked while WebKit loads a large page
+void tst_bench_QLinuxWebView::uiStallDuringLoad()
+{
+    QFETCH(int, size);
+    const QString html = htmlOfSize(size);
+
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    StallMonitor stalls;
+    qint64 longest = 0;
+    for (int run = 0; run < stallRuns; ++run) {
+        stalls.start();
+        view.loadHtml(html);
+        QVERIFY(loads.wait(1));
+        longest = qMax(longest, stalls.stop());
+    }
+    QTest::setBenchmarkResult(longest / 1e6, QTest::WalltimeMilliseconds);
+}
+
+// Same, while a large result is converted and delivered
+void tst_bench_QLinuxWebView::uiStallDuringJavaScript()
+{
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    const QString script = QStringLiteral(
+            "Array.from({ length: 100000 }, (_, i) => ({ id: i, name: 'item ' + i }))");
+    StallMonitor stalls;
+    qint64 longest = 0;
+    for (int run = 0; run < stallRuns; ++run) {
+        stalls.start();
+        QCOMPARE(runJavaScript(view, script).toList().size(), 100000);
+        longest = qMax(longest, stalls.stop());
+    }
+    QTest::setBenchmarkResult(longest / 1e6, QTest::WalltimeMilliseconds);
+}
+
+// Same, while 20 views load at once and flood the GUI thread with events
+void tst_bench_QLinuxWebView::uiStallDuringConcurrentLoads()
+{
+    const int count = 20;
+    const QString html = htmlOfSize(100 * 1024);
+
+    LoadCounter loads;
+    std::vector<std::unique_ptr<QWebView>> views;
+    for (int i = 0; i < count; ++i) {
+        views.emplace_back(new QWebView);
+        loads.watch(views.back().get());
+    }
+
+    StallMonitor stalls;
+    qint64 longest = 0;
+    for (int run = 0; run < stallRuns; ++run) {
+        stalls.start();
+        for (const std::unique_ptr<QWebView> &view : views)
+            view->loadHtml(html);
+        QVERIFY(loads.wait(count));
+        longest = qMax(longest, stalls.stop());
+    }
+    QTest::setBenchmarkResult(longest / 1e6, QTest::WalltimeMilliseconds);
+}
+
+bool tst_bench_QLinuxWebView::showResizablePage(QWebView &view, QWindow &host)
+{
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(QString::fromLatin1(resizeCounterPage));
+    if (!loads.wait(1))
+        return false;
+
+    QWindow *window = view.nativeWindow();
+    if (!window)
+        return false;
+    host.resize(1200, 900);
+    window->setParent(&host);
+    window->setGeometry(0, 0, 400, 300);
+    window->show();
+    host.show();
+    return QTest::qWaitForWindowExposed(&host) && waitForPageSize(view, window->size());
+}
+
+void tst_bench_QLinuxWebView::dragResize_data()
+{
+    QTest::addColumn<int>("settleTime");
+
+    QTest::newRow("once per pass") << 0;
+    QTest::newRow("settle 100 ms") << 100;
+}
+
+// A 60 step drag until the page is laid out at the final size
+void tst_bench_QLinuxWebView::dragResize()
+{
+    QFETCH(int, settleTime);
+
+    // Outlives the view, whose window is its child
+    QWindow host;
+    // Read when the view is created
+    qputenv("QT_WEBVIEW_RESIZE_SETTLE_TIME", QByteArray::number(settleTime));
+    QWebView view;
+    qunsetenv("QT_WEBVIEW_RESIZE_SETTLE_TIME");
+    QVERIFY(showResizablePage(view, host));
+    QWindow *window = view.nativeWindow();
+    const QSize from = window->size();
+
+    QBENCHMARK {
+        window->resize(from);
+        QVERIFY(waitForPageSize(view, from));
+        dragResize(window, from, 60, 0);
+        QVERIFY(waitForPageSize(view, window->size()));
+    }
+}
+
+// Relayouts for the same drag at 60 frames per second, reported as events
+void tst_bench_QLinuxWebView::dragResizeRelayouts()
+{
+    QFETCH(int, settleTime);
+
+    // Outlives the view, whose window is its child
+    QWindow host;
+    qputenv("QT_WEBVIEW_RESIZE_SETTLE_TIME", QByteArray::number(settleTime));
+    QWebView view;
+    qunsetenv("QT_WEBVIEW_RESIZE_SETTLE_TIME");
+    QVERIFY(showResizablePage(view, host));
+    QWindow *window = view.nativeWindow();
+
+    const int before = runJavaScript(view, QStringLiteral("window.resizes")).toInt();
+    dragResize(window, window->size(), 60, 16);
+    QVERIFY(waitForPageSize(view, window->size()));
+    const int relayouts = runJavaScript(view, QStringLiteral("window.resizes")).toInt() - before;
+    QTest::setBenchmarkResult(relayouts, QTest::Events);
+}
+
+QTEST_MAIN(tst_bench_QLinuxWebView)
+
+#include "tst_bench_qlinuxwebview.moc"
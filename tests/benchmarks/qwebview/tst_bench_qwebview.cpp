@@ -0,0 +1,415 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest/QtTest>
+
+#include "webviewbenchmarkutils.h"
+
+#include <qwebview_p.h>
+#include <qwebviewfakebackend_p.h>
+#include <qwebviewloadrequest_p.h>
+
+#include <memory>
+#include <vector>
+
+// A field of /proc/self/status in bytes, -1 if unknown
+static qint64 processStatusBytes(const char *field)
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    const QByteArray prefix = QByteArray(field) + ':';
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith(prefix)) {
+            // "VmHWM:     1234 kB"
+            const QByteArray value = line.mid(prefix.size()).trimmed();
+            return value.left(value.indexOf(' ')).toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+class tst_bench_QWebView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void construction();
+    void loadHtml_data();
+    void loadHtml();
+    void loadData_data();
+    void loadData();
+    void loadDataPeakResident_data() { loadData_data(); }
+    void loadDataPeakResident();
+    void javaScriptRoundTrip();
+    void javaScriptConversion_data();
+    void javaScriptConversion();
+    void javaScriptBatch_data();
+    void javaScriptBatch();
+    void notificationRelay_data();
+    void notificationRelay();
+    void concurrentViews_data();
+    void concurrentViews();
+    void restoreState_data();
+    void restoreState();
+
+private:
+    bool m_fake = false;
+};
+
+void tst_bench_QWebView::initTestCase()
+{
+    QWebView probe;
+    m_fake = qobject_cast<QFakeWebView *>(QWebView::get(probe)) != nullptr;
+    qInfo("Backend: %s", QWebView::get(probe)->metaObject()->className());
+    if (!m_fake)
+        return;
+
+    // Without the delays of the default timeline, only QWebView's own cost is left
+    QFakeWebViewTimeline timeline = QFakeWebView::defaultTimeline();
+    for (QFakeWebViewEvent &event : timeline)
+        event.delay = 0;
+    QFakeWebView::setDefaultTimeline(timeline);
+    QFakeWebView::setDefaultJavaScriptHandler([](const QString &) { return QVariant(2); });
+}
+
+void tst_bench_QWebView::construction()
+{
+    QBENCHMARK {
+        QWebView view;
+    }
+}
+
+void tst_bench_QWebView::loadHtml_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1 KB") << 1024;
+    QTest::newRow("10 KB") << 10 * 1024;
+    QTest::newRow("100 KB") << 100 * 1024;
+    QTest::newRow("1 MB") << 1024 * 1024;
+    QTest::newRow("10 MB") << 10 * 1024 * 1024;
+}
+
+void tst_bench_QWebView::loadHtml()
+{
+    QFETCH(int, size);
+    const QString html = htmlOfSize(size);
+
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    QBENCHMARK {
+        view.loadHtml(html);
+        QVERIFY(loads.wait(1));
+    }
+    QCOMPARE(view.title(), QStringLiteral("bench"));
+}
+
+void tst_bench_QWebView::loadData_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("useData");
+
+    for (int megabytes : { 5, 20 }) {
+        QTest::addRow("%d MB loadHtml", megabytes) << megabytes * 1024 * 1024 << false;
+        QTest::addRow("%d MB loadData", megabytes) << megabytes * 1024 * 1024 << true;
+    }
+}
+
+// Generated reports, which the application has as UTF-8 for loadData()
+void tst_bench_QWebView::loadData()
+{
+    QFETCH(int, size);
+    QFETCH(bool, useData);
+    const QString html = htmlOfSize(size);
+    const QByteArray data = html.toUtf8();
+
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    QBENCHMARK {
+        if (useData)
+            view.loadData(data);
+        else
+            view.loadHtml(html);
+        QVERIFY(loads.wait(1));
+    }
+}
+
+// How far the resident size of this process peaks above its size before the
+// load. The copies made in the web process are not included.
+void tst_bench_QWebView::loadDataPeakResident()
+{
+    QFETCH(int, size);
+    QFETCH(bool, useData);
+    const QString html = useData ? QString() : htmlOfSize(size);
+    const QByteArray data = useData ? htmlOfSize(size).toUtf8() : QByteArray();
+
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    // Writing 5 resets the peak, VmHWM, to the current size (Linux 4.0)
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (!clearRefs.open(QIODevice::WriteOnly) || clearRefs.write("5") != 1)
+        QSKIP("The peak resident size cannot be reset here");
+    clearRefs.close();
+    const qint64 before = processStatusBytes("VmRSS");
+
+    if (useData)
+        view.loadData(data);
+    else
+        view.loadHtml(html);
+    QVERIFY(loads.wait(1));
+
+    const qint64 peak = processStatusBytes("VmHWM");
+    QVERIFY(before > 0 && peak > 0);
+    QTest::setBenchmarkResult(qreal(peak - before), QTest::BytesAllocated);
+}
+
+void tst_bench_QWebView::javaScriptRoundTrip()
+{
+    QWebView view;
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    QBENCHMARK {
+        QCOMPARE(runJavaScript(view, QStringLiteral("1 + 1")).toInt(), 2);
+    }
+}
+
+void tst_bench_QWebView::javaScriptConversion_data()
+{
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<QVariant>("fakeResult"); // what the fake backend answers
+
+    QVariantList numbers;
+    QVariantList objects;
+    QVariantList references;
+    const QVariantMap shared { { QStringLiteral("id"), 0 } };
+    for (int i = 0; i < 100000; ++i) {
+        numbers.append(i);
+        if (i < 10000)
+            objects.append(QVariantMap { { QStringLiteral("id"), i },
+                                         { QStringLiteral("name"), QString::number(i) } });
+        if (i < 1000)
+            references.append(shared);
+    }
+
+    QTest::newRow("number") << QStringLiteral("42") << QVariant(42);
+    QTest::newRow("string 1 MB") << QStringLiteral("'x'.repeat(1024 * 1024)")
+                                 << QVariant(QString(1024 * 1024, QLatin1Char('x')));
+    QTest::newRow("100000 numbers")
+            << QStringLiteral("Array.from({ length: 100000 }, (_, i) => i)") << QVariant(numbers);
+    QTest::newRow("10000 objects")
+            << QStringLiteral("Array.from({ length: 10000 }, (_, i) => ({ id: i, name: '' + i }))")
+            << QVariant(objects);
+    QTest::newRow("1000 references to one object")
+            << QStringLiteral("Array(1000).fill({ id: 0 })")
+            << QVariant(references);
+    // Fails like JSON.stringify, and must not walk the cycles
+    QTest::newRow("window") << QStringLiteral("window")
+                            << QVariant(QStringLiteral("TypeError: cyclic"));
+}
+
+// Round trips of small and large results, on Linux mostly the JSCValue conversion
+void tst_bench_QWebView::javaScriptConversion()
+{
+    QFETCH(QString, script);
+    QFETCH(QVariant, fakeResult);
+
+    QWebView view;
+    if (QFakeWebView *fake = qobject_cast<QFakeWebView *>(QWebView::get(view)))
+        fake->setJavaScriptHandler([fakeResult](const QString &) { return fakeResult; });
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    QBENCHMARK {
+        QVERIFY(runJavaScript(view, script).isValid());
+    }
+}
+
+void tst_bench_QWebView::javaScriptBatch_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("batched");
+
+    for (int count : { 10, 50 }) {
+        QTest::addRow("%d single calls", count) << count << false;
+        QTest::addRow("%d in one batch", count) << count << true;
+    }
+}
+
+// A refresh issuing count small scripts at once, until all results are in
+void tst_bench_QWebView::javaScriptBatch()
+{
+    QFETCH(int, count);
+    QFETCH(bool, batched);
+
+    QStringList scripts;
+    for (int i = 0; i < count; ++i)
+        scripts.append(QStringLiteral("%1 + 1").arg(i));
+
+    QWebView view;
+    if (QFakeWebView *fake = qobject_cast<QFakeWebView *>(QWebView::get(view))) {
+        // Answers the batch wrapper of QWebView like an engine would
+        QVariantList entries;
+        for (int i = 0; i < count; ++i)
+            entries.append(QVariantMap { { QStringLiteral("value"), i + 1 } });
+        fake->setJavaScriptHandler([entries](const QString &script) {
+            return script.startsWith(QLatin1String("(function(scripts)")) ? QVariant(entries)
+                                                                          : QVariant(2);
+        });
+    }
+    LoadCounter loads;
+    loads.watch(&view);
+    view.loadHtml(htmlOfSize(1024));
+    QVERIFY(loads.wait(1));
+
+    int received = 0;
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(&view, &QWebView::javaScriptResult, &loop, [&](int, const QVariant &) {
+        if (++received == count)
+            loop.quit();
+    });
+    connect(&view, &QWebView::javaScriptBatchResult, &loop,
+            [&](int, const QVariantList &results, const QStringList &) {
+                received += results.size();
+                loop.quit();
+            });
+
+    QBENCHMARK {
+        received = 0;
+        if (batched) {
+            view.runJavaScriptBatch(scripts, 1);
+        } else {
+            for (int i = 0; i < count; ++i)
+                static_cast<QAbstractWebView &>(view).runJavaScriptPrivate(scripts.at(i), i + 1);
+        }
+        timeout.start(60000);
+        loop.exec();
+        timeout.stop();
+        QCOMPARE(received, count);
+    }
+}
+
+void tst_bench_QWebView::notificationRelay_data()
+{
+    QTest::addColumn<int>("interval");
+
+    QTest::newRow("immediate") << 0;
+    QTest::newRow("coalesced 16 ms") << 16;
+}
+
+// What QWebView adds to each progress and title change the backend reports
+void tst_bench_QWebView::notificationRelay()
+{
+    QFETCH(int, interval);
+
+    QWebView view;
+    view.setNotificationInterval(interval);
+    QAbstractWebView *backend = QWebView::get(view);
+    int relayed = 0;
+    connect(&view, &QWebView::loadProgressChanged, this, [&relayed]() { ++relayed; });
+    connect(&view, &QWebView::titleChanged, this, [&relayed]() { ++relayed; });
+
+    QStringList titles;
+    for (int i = 0; i <= 100; ++i)
+        titles.append(QString::number(i));
+
+    QBENCHMARK {
+        for (int progress = 0; progress <= 100; ++progress) {
+            Q_EMIT backend->loadProgressChanged(progress);
+            Q_EMIT backend->titleChanged(titles.at(progress));
+        }
+    }
+    QCOMPARE(view.loadProgress(), 100);
+    if (interval == 0)
+        QVERIFY(relayed > 0);
+}
+
+void tst_bench_QWebView::concurrentViews_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10 views") << 10;
+    QTest::newRow("50 views") << 50;
+    QTest::newRow("100 views") << 100;
+}
+
+// Creates the views, loads a page in all of them at once and destroys them
+void tst_bench_QWebView::concurrentViews()
+{
+    QFETCH(int, count);
+    const QString html = htmlOfSize(10 * 1024);
+
+    QBENCHMARK {
+        LoadCounter loads;
+        std::vector<std::unique_ptr<QWebView>> views;
+        views.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            views.emplace_back(new QWebView);
+            loads.watch(views.back().get());
+        }
+        for (const std::unique_ptr<QWebView> &view : views)
+            view->loadHtml(html);
+        QVERIFY(loads.wait(count));
+    }
+}
+
+void tst_bench_QWebView::restoreState_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1 view") << 1;
+    QTest::newRow("30 views") << 30;
+}
+
+// Application startup: the views are created from saved states, until all
+// have loaded. Includes the staggering of the restore queue.
+void tst_bench_QWebView::restoreState()
+{
+    QFETCH(int, count);
+
+    QByteArray state;
+    {
+        QWebView view;
+        LoadCounter loads;
+        loads.watch(&view);
+        for (int page = 0; page < 3; ++page) {
+            view.setUrl(QUrl(QStringLiteral("data:text/html,<title>%1</title>%2")
+                                     .arg(page)
+                                     .arg(htmlOfSize(10 * 1024))));
+            QVERIFY(loads.wait(1));
+        }
+        state = view.saveState();
+    }
+
+    QBENCHMARK {
+        LoadCounter loads;
+        std::vector<std::unique_ptr<QWebView>> views;
+        views.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            views.emplace_back(new QWebView);
+            loads.watch(views.back().get());
+            QVERIFY(views.back()->restoreState(state));
+        }
+        QVERIFY(loads.wait(count));
+    }
+}
+
+QTEST_MAIN(tst_bench_QWebView)
+
+#include "tst_bench_qwebview.moc"
@@ -0,0 +1,136 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#ifndef WEBVIEWBENCHMARKUTILS_H
+#define WEBVIEWBENCHMARKUTILS_H
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qeventloop.h>
+#include <QtCore/qtimer.h>
+
+#include <qwebview_p.h>
+#include <qwebviewloadrequest_p.h>
+
+// Counts the finished loads of the views it watches
+class LoadCounter : public QObject
+{
+public:
+    LoadCounter()
+    {
+        m_timeout.setSingleShot(true);
+        connect(&m_timeout, &QTimer::timeout, &m_loop, &QEventLoop::quit);
+    }
+
+    void watch(QWebView *view)
+    {
+        connect(view, &QWebView::loadingChanged, this,
+                [this](const QWebViewLoadRequestPrivate &request) {
+                    if (request.m_status != QWebView::LoadSucceededStatus
+                        && request.m_status != QWebView::LoadFailedStatus
+                        && request.m_status != QWebView::LoadStoppedStatus) {
+                        return;
+                    }
+                    if (request.m_status != QWebView::LoadSucceededStatus)
+                        ++m_failed;
+                    if (++m_finished >= m_expected)
+                        m_loop.quit();
+                });
+    }
+
+    // Waits for count more loads, false on a timeout or a failed load
+    bool wait(int count, int timeout = 60000)
+    {
+        m_expected = m_finished + count;
+        const int failed = m_failed;
+        if (m_finished < m_expected) {
+            m_timeout.start(timeout);
+            m_loop.exec();
+            m_timeout.stop();
+        }
+        return m_finished >= m_expected && m_failed == failed;
+    }
+
+private:
+    QEventLoop m_loop;
+    QTimer m_timeout;
+    int m_finished = 0;
+    int m_failed = 0;
+    int m_expected = 0;
+};
+
+// Runs the script and waits for its result
+inline QVariant runJavaScript(QWebView &view, const QString &script, int timeout = 60000)
+{
+    static int lastCallbackId = 0;
+    const int callbackId = ++lastCallbackId;
+    QVariant result;
+    QEventLoop loop;
+    QObject::connect(&view, &QWebView::javaScriptResult, &loop,
+                     [&](int id, const QVariant &value) {
+                         if (id != callbackId)
+                             return;
+                         result = value;
+                         loop.quit();
+                     });
+    QTimer::singleShot(timeout, &loop, &QEventLoop::quit);
+    static_cast<QAbstractWebView &>(view).runJavaScriptPrivate(script, callbackId);
+    loop.exec();
+    return result;
+}
+
+// A valid page of about size bytes, titled "bench"
+inline QString htmlOfSize(int size)
+{
+    const QString head = QStringLiteral("<html><head><title>bench</title></head><body><p>");
+    const QString tail = QStringLiteral("</p></body></html>");
+    const QString words = QStringLiteral("lorem ipsum dolor sit amet ");
+    QString html = head;
+    html.reserve(size + words.size());
+    while (html.size() + tail.size() < size)
+        html += words;
+    return html + tail;
+}
+
+// The longest the GUI thread went without running a 1 ms timer, which is how
+// long the UI would have stalled
+class StallMonitor : public QObject
+{
+public:
+    StallMonitor()
+    {
+        m_timer.setTimerType(Qt::PreciseTimer);
+        m_timer.setInterval(1);
+        connect(&m_timer, &QTimer::timeout, this, [this]() { tick(); });
+    }
+
+    void start()
+    {
+        m_longest = 0;
+        m_clock.start();
+        m_last = 0;
+        m_timer.start();
+    }
+
+    // nsecs
+    qint64 stop()
+    {
+        m_timer.stop();
+        tick();
+        return m_longest;
+    }
+
+private:
+    void tick()
+    {
+        const qint64 now = m_clock.nsecsElapsed();
+        m_longest = qMax(m_longest, now - m_last);
+        m_last = now;
+    }
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_last = 0;
+    qint64 m_longest = 0;
+};
+
+#endif // WEBVIEWBENCHMARKUTILS_H